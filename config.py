@@ -2,6 +2,18 @@ def can_build(env, platform):
     return not env["disable_3d"]
 
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable
+
+    return [
+        BoolVariable(
+            "many_bone_ik_float_kernels",
+            "Run the batched IK solver kernels in single precision instead of double",
+            False,
+        ),
+    ]
+
+
 def configure(env):
     pass
 
@@ -14,9 +26,11 @@ def get_doc_classes():
         "IKBoneSegment3D",
         "IKEffectorTemplate3D",
         "IKKusudama3D",
+        "IKKusudamaFitter3D",
         "IKRay3D",
         "IKNode3D",
         "IKLimitCone3D",
+        "IKSolveScheduler3D",
     ]
 
 
@@ -34,6 +34,8 @@
 #include "src/ik_effector_3d.h"
 #include "src/ik_effector_template_3d.h"
 #include "src/ik_kusudama_3d.h"
+#include "src/ik_kusudama_fitter_3d.h"
+#include "src/ik_solve_scheduler_3d.h"
 #include "src/many_bone_ik_3d.h"
 
 #ifdef TOOLS_ENABLED
@@ -56,8 +58,10 @@ void initialize_many_bone_ik_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(IKEffector3D);
 		GDREGISTER_CLASS(IKBoneSegment3D);
 		GDREGISTER_CLASS(IKKusudama3D);
+		GDREGISTER_CLASS(IKKusudamaFitter3D);
 		GDREGISTER_CLASS(IKRay3D);
 		GDREGISTER_CLASS(IKLimitCone3D);
+		GDREGISTER_CLASS(IKSolveScheduler3D);
 	}
 }
 
@@ -217,6 +217,17 @@ IKBone3D::IKBone3D(StringName p_bone, Skeleton3D *p_skeleton, const Ref<IKBone3D
 			effector->set_motion_propagation_factor(elem->get_motion_propagation_factor());
 			effector->set_weight(elem->get_weight());
 			effector->set_direction_priorities(elem->get_direction_priorities());
+			// Only an ancestor of the pinned bone can scope the pin.
+			const BoneId root_bone_id = elem->get_root_bone().is_empty() ? BoneId(-1) : p_skeleton->find_bone(elem->get_root_bone());
+			for (BoneId ancestor = bone_id; ancestor != -1; ancestor = p_skeleton->get_bone_parent(ancestor)) {
+				if (ancestor == root_bone_id) {
+					effector->set_root_bone_id(root_bone_id);
+					break;
+				}
+			}
+			if (elem->is_target_transform_enabled()) {
+				effector->set_target_transform(elem->get_target_transform(), elem->is_target_transform_world(), p_skeleton->get_global_transform().affine_inverse());
+			}
 			break;
 		}
 	}
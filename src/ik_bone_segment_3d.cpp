@@ -30,6 +30,7 @@
 
 #include "ik_bone_segment_3d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/string/string_builder.h"
 #include "ik_effector_3d.h"
 #include "ik_kusudama_3d.h"
@@ -49,6 +50,53 @@ bool IKBoneSegment3D::is_pinned() const {
 	return tip->is_pinned();
 }
 
+bool IKBoneSegment3D::is_two_bone_chain() const {
+	return two_bone_chain;
+}
+
+bool IKBoneSegment3D::is_jacobi_update() const {
+	return jacobi_update;
+}
+
+void IKBoneSegment3D::set_lod(bool p_stabilization_enabled, int32_t p_freeze_depth, int32_t p_depth) {
+	stabilization_enabled = p_stabilization_enabled;
+	// A negative depth freezes nothing; the root segment at depth zero is never frozen.
+	frozen = p_freeze_depth >= 0 && p_depth > p_freeze_depth;
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		if (child.is_valid()) {
+			child->set_lod(p_stabilization_enabled, p_freeze_depth, p_depth + 1);
+		}
+	}
+}
+
+bool IKBoneSegment3D::is_frozen() const {
+	return frozen;
+}
+
+int32_t IKBoneSegment3D::update_solve_pending(bool p_all) {
+	// The effector list already follows the motion propagation factors up through the parent segments.
+	solve_pending = p_all;
+	for (int32_t effector_i = 0; effector_i < effector_list.size() && !solve_pending; effector_i++) {
+		solve_pending = effector_list[effector_i].is_valid() && effector_list[effector_i]->target_moved;
+	}
+	int32_t pending_count = solve_pending && !frozen ? 1 : 0;
+	// Solving this segment moves every segment below it, so their tips have to follow their targets again.
+	for (Ref<IKBoneSegment3D> child : child_segments) {
+		if (child.is_valid()) {
+			pending_count += child->update_solve_pending(p_all || solve_pending);
+		}
+	}
+	return pending_count;
+}
+
+bool IKBoneSegment3D::is_solve_pending() const {
+	return solve_pending;
+}
+
+int32_t IKBoneSegment3D::get_solver_backend() const {
+	return solver_backend_type;
+}
+
 Vector<Ref<IKBoneSegment3D>> IKBoneSegment3D::get_child_segments() const {
 	return child_segments;
 }
@@ -76,13 +124,18 @@ void IKBoneSegment3D::update_pinned_list(Vector<Vector<double>> &r_weights) {
 		Ref<IKBoneSegment3D> chain = child_segments[chain_i];
 		chain->update_pinned_list(r_weights);
 	}
-	if (is_pinned()) {
+	effector_list.clear();
+	if (is_pinned() && _is_pin_solved(tip->get_pin())) {
 		effector_list.push_back(tip->get_pin());
 	}
 	double motion_propagation_factor = is_pinned() ? tip->get_pin()->motion_propagation_factor : 1.0;
 	if (motion_propagation_factor > 0.0) {
 		for (Ref<IKBoneSegment3D> child : child_segments) {
-			effector_list.append_array(child->effector_list);
+			for (const Ref<IKEffector3D> &effector : child->effector_list) {
+				if (_is_pin_solved(effector)) {
+					effector_list.push_back(effector);
+				}
+			}
 		}
 	}
 }
@@ -111,19 +164,16 @@ Quaternion IKBoneSegment3D::clamp_to_cos_half_angle(Quaternion p_quat, double p_
 	return p_quat;
 }
 
-float IKBoneSegment3D::_get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights) {
-	float manual_RMSD = 0.0f;
-	float w_sum = 0.0f;
+double IKBoneSegment3D::_get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights) {
+	// Accumulate in the weights' precision; the headings are only widened once per component.
+	double manual_RMSD = 0.0;
+	double w_sum = 0.0;
 	for (int i = 0; i < r_htarget.size(); i++) {
-		float x_d = r_htarget[i].x - r_htip[i].x;
-		float y_d = r_htarget[i].y - r_htip[i].y;
-		float z_d = r_htarget[i].z - r_htip[i].z;
-		float mag_sq = p_weights[i] * (x_d * x_d + y_d * y_d + z_d * z_d);
-		manual_RMSD += mag_sq;
+		const Vector3 delta = r_htarget[i] - r_htip[i];
+		manual_RMSD += p_weights[i] * (double(delta.x) * delta.x + double(delta.y) * delta.y + double(delta.z) * delta.z);
 		w_sum += p_weights[i];
 	}
-	manual_RMSD /= w_sum * w_sum;
-	return manual_RMSD;
+	return w_sum > 0.0 ? manual_RMSD / w_sum : 0.0;
 }
 
 void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_htip, PackedVector3Array *r_htarget, Vector<double> *r_weights, float p_dampening, bool p_translate, bool p_constraint_mode, double current_iteration, double total_iterations) {
@@ -136,13 +186,18 @@ void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVect
 	Transform3D prev_transform = p_for_bone->get_pose();
 	bool got_closer = true;
 	double bone_damp = p_for_bone->get_cos_half_dampen();
+	const int32_t stabilizing_pass_count = stabilization_enabled ? default_stabilizing_pass_count : 0;
 	int i = 0;
 	do {
 		_update_tip_headings(p_for_bone, &tip_headings);
+		const Transform3D prev_global_pose = p_for_bone->get_global_pose();
+		const Quaternion prev_rotation = prev_global_pose.basis.get_rotation_quaternion();
+		QuaternionCharacteristicPolynomial::Superposition superposition;
 		if (!p_constraint_mode) {
-			Array superpose_result = QuaternionCharacteristicPolynomial::weighted_superpose(*r_htip, *r_htarget, *r_weights, p_translate, evec_prec);
-			Quaternion rotation = superpose_result[0];
-			Vector3 translation = superpose_result[1];
+			// Only a stabilization pass scores the fit, so only then is the residual worth its eigenvalue solve.
+			superposition = QuaternionCharacteristicPolynomial::superpose(*r_htip, *r_htarget, *r_weights, p_translate, evec_prec, QuaternionCharacteristicPolynomial::METHOD_QCP, stabilizing_pass_count > 0);
+			Quaternion rotation = superposition.rotation;
+			Vector3 translation = superposition.translation;
 			double dampening = (p_dampening != -1.0) ? p_dampening : bone_damp;
 			rotation = clamp_to_cos_half_angle(rotation, cos(dampening / 2.0));
 			if (current_iteration == 0) {
@@ -153,16 +208,20 @@ void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVect
 			Transform3D result = Transform3D(p_for_bone->get_global_pose().basis, p_for_bone->get_global_pose().origin + translation);
 			p_for_bone->set_global_pose(result);
 		}
-		bool is_parent_valid = p_for_bone->get_parent().is_valid();
-		if (is_parent_valid && p_for_bone->is_orientationally_constrained()) {
-			p_for_bone->get_constraint()->snap_to_orientation_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_orientation_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
-		}
-		if (is_parent_valid && p_for_bone->is_axially_constrained()) {
-			p_for_bone->get_constraint()->set_snap_to_twist_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_twist_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
-		}
-		if (default_stabilizing_pass_count > 0) {
-			_update_tip_headings(p_for_bone, &tip_headings_uniform);
-			double current_msd = _get_manual_msd(tip_headings_uniform, target_headings, heading_weights);
+		_snap_to_constraints(p_for_bone);
+		if (stabilizing_pass_count > 0) {
+			// The headings are measured from this bone's origin, so whatever rotation the bone ended up with rotates them rigidly,
+			// and QCP's sums score it without walking the effectors again. Constraint mode never ran QCP, so it measures directly.
+			double current_msd;
+			if (!p_constraint_mode) {
+				// The root segment's bone is translated too, which moves every tip heading against the fixed targets.
+				const Transform3D applied_pose = p_for_bone->get_global_pose();
+				const Quaternion applied_rotation = applied_pose.basis.get_rotation_quaternion() * prev_rotation.inverse();
+				current_msd = superposition.get_msd(applied_rotation, applied_pose.origin - prev_global_pose.origin);
+			} else {
+				_update_tip_headings(p_for_bone, &tip_headings_uniform);
+				current_msd = _get_manual_msd(tip_headings_uniform, target_headings, heading_weights);
+			}
 			if (current_msd <= previous_deviation * 1.0001) {
 				previous_deviation = current_msd;
 				got_closer = true;
@@ -173,13 +232,26 @@ void IKBoneSegment3D::_set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVect
 			}
 		}
 		i++;
-	} while (i < default_stabilizing_pass_count && !got_closer);
+	} while (i < stabilizing_pass_count && !got_closer);
 
 	if (root == p_for_bone) {
 		previous_deviation = INFINITY;
 	}
 }
 
+void IKBoneSegment3D::_snap_to_constraints(const Ref<IKBone3D> &p_for_bone) {
+	if (p_for_bone->get_parent().is_null()) {
+		return;
+	}
+	double bone_damp = p_for_bone->get_cos_half_dampen();
+	if (p_for_bone->is_orientationally_constrained()) {
+		p_for_bone->get_constraint()->snap_to_orientation_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_orientation_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
+	}
+	if (p_for_bone->is_axially_constrained()) {
+		p_for_bone->get_constraint()->set_snap_to_twist_limit(p_for_bone->get_bone_direction_transform(), p_for_bone->get_ik_transform(), p_for_bone->get_constraint_twist_transform(), bone_damp, p_for_bone->get_cos_half_dampen());
+	}
+}
+
 void IKBoneSegment3D::_update_target_headings(Ref<IKBone3D> p_for_bone, Vector<double> *r_weights, PackedVector3Array *r_target_headings) {
 	ERR_FAIL_COND(p_for_bone.is_null());
 	ERR_FAIL_NULL(r_weights);
@@ -208,39 +280,228 @@ void IKBoneSegment3D::_update_tip_headings(Ref<IKBone3D> p_for_bone, PackedVecto
 }
 
 void IKBoneSegment3D::segment_solver(const Vector<float> &p_damp, float p_default_damp, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iteration) {
+	if (frozen) {
+		// Every descendant is frozen too.
+		return;
+	}
 	for (Ref<IKBoneSegment3D> child : child_segments) {
 		if (child.is_null()) {
 			continue;
 		}
 		child->segment_solver(p_damp, p_default_damp, p_constraint_mode, p_current_iteration, p_total_iteration);
 	}
+	if (!solve_pending) {
+		return;
+	}
 	bool is_translate = parent_segment.is_null();
 	if (is_translate) {
-		Vector<float> damp = p_damp;
-		damp.fill(Math::PI);
-		_qcp_solver(damp, Math::PI, is_translate, p_constraint_mode, p_current_iteration, p_total_iteration);
+		// The root segment is undamped; an empty list sends every bone to the default.
+		_solve_with_backend(Vector<float>(), Math::PI, is_translate, p_constraint_mode, p_current_iteration, p_total_iteration);
 		return;
 	}
-	_qcp_solver(p_damp, p_default_damp, is_translate, p_constraint_mode, p_current_iteration, p_total_iteration);
+	if (two_bone_chain && !p_constraint_mode && !effector_list.is_empty()) {
+		if (p_current_iteration == 0) {
+			two_bone_chain_constrained = false;
+		}
+		if (!two_bone_chain_constrained && _solve_two_bone_chain(p_damp, p_default_damp, p_current_iteration, p_total_iteration)) {
+			return;
+		}
+		// The constraints moved the chain off the closed form solution, so iterate for the rest of the frame.
+		two_bone_chain_constrained = true;
+	}
+	_solve_with_backend(p_damp, p_default_damp, is_translate, p_constraint_mode, p_current_iteration, p_total_iteration);
+}
+
+void IKBoneSegment3D::_solve_with_backend(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	if (solver_backend) {
+		solver_backend->solve(this, p_damp, p_default_damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+		return;
+	}
+	_qcp_solver(p_damp, p_default_damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+}
+
+bool IKBoneSegment3D::_is_two_bone_chain() const {
+	if (bones.size() != 3 || parent_segment.is_null() || !child_segments.is_empty()) {
+		return false;
+	}
+	return is_pinned();
+}
+
+bool IKBoneSegment3D::_solve_two_bone_chain(const Vector<float> &p_damp, float p_default_damp, int32_t p_current_iteration, int32_t p_total_iterations) {
+	// The bone list runs from the tip, so it holds the pinned bone, then the lower and upper limb bones.
+	const Ref<IKBone3D> &end_bone = bones[0];
+	const Ref<IKBone3D> &lower_bone = bones[1];
+	const Ref<IKBone3D> &upper_bone = bones[2];
+	const Ref<IKEffector3D> &effector = end_bone->get_pin();
+
+	const Vector3 upper_origin = upper_bone->get_bone_direction_global_pose().origin;
+	const Vector3 lower_origin = lower_bone->get_bone_direction_global_pose().origin;
+	Vector3 end_origin = end_bone->get_bone_direction_global_pose().origin;
+	const real_t upper_length = upper_origin.distance_to(lower_origin);
+	const real_t lower_length = lower_origin.distance_to(end_origin);
+	if (upper_length < CMP_EPSILON || lower_length < CMP_EPSILON) {
+		return false;
+	}
+	const Vector3 to_target = effector->get_target_global_transform().origin - upper_origin;
+	const real_t reach = CLAMP(to_target.length(), Math::abs(upper_length - lower_length) + CMP_EPSILON, upper_length + lower_length - CMP_EPSILON);
+
+	// Open or close the middle joint until the chain spans the target distance (law of cosines).
+	const Vector3 lower_to_upper = upper_origin - lower_origin;
+	const Vector3 lower_to_end = end_origin - lower_origin;
+	Vector3 bend_axis = lower_to_upper.cross(lower_to_end);
+	if (bend_axis.length_squared() < CMP_EPSILON2) {
+		// A straight limb has no bend plane; fall back to the lower bone's own X axis, the usual knee or elbow hinge.
+		bend_axis = lower_bone->get_bone_direction_global_pose().basis.get_column(Vector3::AXIS_X);
+	}
+	const real_t current_angle = lower_to_upper.angle_to(lower_to_end);
+	const real_t target_angle = Math::acos(CLAMP((upper_length * upper_length + lower_length * lower_length - reach * reach) / (2.0f * upper_length * lower_length), real_t(-1.0), real_t(1.0)));
+	lower_bone->get_ik_transform()->rotate_local_with_global(Basis(bend_axis.normalized(), target_angle - current_angle));
+
+	// Swing the upper bone so the end of the chain lands on the target.
+	end_origin = end_bone->get_bone_direction_global_pose().origin;
+	const Vector3 to_end = end_origin - upper_origin;
+	if (to_target.length_squared() > CMP_EPSILON2 && to_end.length_squared() > CMP_EPSILON2) {
+		upper_bone->get_ik_transform()->rotate_local_with_global(Basis(Quaternion(to_end.normalized(), to_target.normalized())));
+	}
+
+	const Transform3D upper_pose = upper_bone->get_pose();
+	const Transform3D lower_pose = lower_bone->get_pose();
+	_snap_to_constraints(upper_bone);
+	_snap_to_constraints(lower_bone);
+	if (!upper_pose.is_equal_approx(upper_bone->get_pose()) || !lower_pose.is_equal_approx(lower_bone->get_pose())) {
+		return false;
+	}
+
+	// Only the pinned bone's own orientation is left, which is a single-bone fit.
+	if (!effector->is_following_translation_only()) {
+		_update_optimal_rotation(end_bone, _get_bone_damp(end_bone, p_damp, p_default_damp), false, false, p_current_iteration, p_total_iterations);
+	}
+	return true;
+}
+
+float IKBoneSegment3D::_get_bone_damp(const Ref<IKBone3D> &p_for_bone, const Vector<float> &p_damp, float p_default_damp) const {
+	float damp = p_default_damp;
+	const BoneId bone_id = p_for_bone->get_bone_id();
+	bool is_valid_access = bone_id >= 0 && bone_id < p_damp.size();
+	if (is_valid_access) {
+		damp = p_damp[p_for_bone->get_bone_id()];
+	}
+	bool is_non_default_damp = p_default_damp < damp;
+	if (is_non_default_damp) {
+		damp = p_default_damp;
+	}
+	return damp;
 }
 
 void IKBoneSegment3D::_qcp_solver(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	if (jacobi_update && !p_translate && !p_constraint_mode && bones.size() > 1) {
+		_qcp_jacobi_solver(p_damp, p_default_damp);
+		return;
+	}
 	for (Ref<IKBone3D> current_bone : bones) {
-		float damp = p_default_damp;
-		bool is_valid_access = !(unlikely((p_damp.size()) < 0 || (current_bone->get_bone_id()) >= (p_damp.size())));
-		if (is_valid_access) {
-			damp = p_damp[current_bone->get_bone_id()];
+		_update_optimal_rotation(current_bone, _get_bone_damp(current_bone, p_damp, p_default_damp), p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+	}
+}
+
+void IKBoneSegment3D::_qcp_jacobi_solver(const Vector<float> &p_damp, float p_default_damp) {
+	const int32_t bone_count = bones.size();
+	const int32_t heading_count = heading_weights.size();
+	if (jacobi_tip_headings.size() != bone_count || (bone_count > 0 && jacobi_tip_headings[0].size() != heading_count)) {
+		jacobi_tip_headings.resize(bone_count);
+		jacobi_target_headings.resize(bone_count);
+		for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+			jacobi_tip_headings.write[bone_i].resize(heading_count);
+			jacobi_target_headings.write[bone_i].resize(heading_count);
 		}
-		bool is_non_default_damp = p_default_damp < damp;
-		if (is_non_default_damp) {
-			damp = p_default_damp;
+		jacobi_batch_tip_headings.resize(heading_count * bone_count);
+		jacobi_batch_target_headings.resize(heading_count * bone_count);
+		jacobi_rotations.resize(bone_count);
+	}
+
+	// Global poses are computed lazily, so settle every one the fits will read before any worker touches them.
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		bones[bone_i]->get_bone_direction_global_pose();
+	}
+	for (const Ref<IKEffector3D> &effector : effector_list) {
+		if (effector.is_valid()) {
+			effector->get_ik_bone_3d()->get_bone_direction_global_pose();
 		}
-		_update_optimal_rotation(current_bone, damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+	}
+
+	// Short chains do not amortize the task dispatch.
+	const int32_t PARALLEL_BONE_THRESHOLD = 32;
+	const int32_t block_count = (bone_count + JACOBI_BLOCK_SIZE - 1) / JACOBI_BLOCK_SIZE;
+	if (bone_count >= PARALLEL_BONE_THRESHOLD) {
+		WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &IKBoneSegment3D::_gather_bone_headings, bone_count, bone_count, -1, true, SNAME("IKBoneSegment3D::jacobi_headings"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+		group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &IKBoneSegment3D::_solve_jacobi_block, bone_count, block_count, -1, true, SNAME("IKBoneSegment3D::jacobi_solve"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	} else {
+		for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+			_gather_bone_headings(bone_i, bone_count);
+		}
+		for (int32_t block_i = 0; block_i < block_count; block_i++) {
+			_solve_jacobi_block(block_i, bone_count);
+		}
+	}
+
+	// Every bone asked for the whole correction on its own, but its damping may only let it make part of it.
+	// The shares add up to how many times over the chain would correct the error if every bone applied its
+	// rotation, so they are scaled back only when that exceeds the relaxation. A long damped chain therefore
+	// still corrects as much per sweep as a short one.
+	real_t total_share = 0.0;
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Quaternion fitted = jacobi_rotations[bone_i];
+		const Quaternion clamped = clamp_to_cos_half_angle(fitted, Math::cos(_get_bone_damp(bones[bone_i], p_damp, p_default_damp) / 2.0));
+		const real_t fitted_angle = 2.0 * Math::acos(MIN(Math::abs(fitted.w), real_t(1.0)));
+		if (fitted_angle > CMP_EPSILON) {
+			total_share += 2.0 * Math::acos(MIN(Math::abs(clamped.w), real_t(1.0))) / fitted_angle;
+		}
+		jacobi_rotations[bone_i] = clamped;
+	}
+	const real_t weight = total_share > jacobi_relaxation ? jacobi_relaxation / total_share : real_t(1.0);
+	// Going from the tip applies each rotation in the frame it was fitted in, before its ancestors move it.
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bones[bone_i];
+		bone->get_ik_transform()->rotate_local_with_global(Basis(Quaternion().slerp(jacobi_rotations[bone_i], weight)));
+		_snap_to_constraints(bone);
 	}
 }
 
+void IKBoneSegment3D::_gather_bone_headings(uint32_t p_bone_index, int32_t p_bone_count) {
+	const Ref<IKBone3D> &bone = bones[p_bone_index];
+	PackedVector3Array &tip = jacobi_tip_headings.write[p_bone_index];
+	PackedVector3Array &target = jacobi_target_headings.write[p_bone_index];
+	int32_t tip_index = 0;
+	int32_t target_index = 0;
+	for (const Ref<IKEffector3D> &effector : effector_list) {
+		if (effector.is_null()) {
+			continue;
+		}
+		target_index = effector->update_effector_target_headings(&target, target_index, bone, &heading_weights);
+		tip_index = effector->update_effector_tip_headings(&tip, tip_index, bone);
+	}
+	// Interleave by bone, so QCP reads neighbouring bones' headings as neighbouring lanes.
+	const Vector3 *tip_ptr = tip.ptr();
+	const Vector3 *target_ptr = target.ptr();
+	for (int32_t heading_i = 0; heading_i < tip.size(); heading_i++) {
+		jacobi_batch_tip_headings[heading_i * p_bone_count + p_bone_index] = tip_ptr[heading_i];
+		jacobi_batch_target_headings[heading_i * p_bone_count + p_bone_index] = target_ptr[heading_i];
+	}
+}
+
+void IKBoneSegment3D::_solve_jacobi_block(uint32_t p_block_index, int32_t p_bone_count) {
+	const int32_t first = p_block_index * JACOBI_BLOCK_SIZE;
+	const int32_t count = MIN(JACOBI_BLOCK_SIZE, p_bone_count - first);
+	QuaternionCharacteristicPolynomial::weighted_superpose_batch(jacobi_batch_tip_headings.ptr() + first, jacobi_batch_target_headings.ptr() + first, heading_weights.ptr(),
+			heading_weights.size(), count, p_bone_count, jacobi_rotations.ptr() + first, nullptr, evec_prec);
+}
+
 void IKBoneSegment3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_pinned"), &IKBoneSegment3D::is_pinned);
+	ClassDB::bind_method(D_METHOD("is_two_bone_chain"), &IKBoneSegment3D::is_two_bone_chain);
+	ClassDB::bind_method(D_METHOD("get_solver_backend"), &IKBoneSegment3D::get_solver_backend);
+	ClassDB::bind_method(D_METHOD("is_jacobi_update"), &IKBoneSegment3D::is_jacobi_update);
 	ClassDB::bind_method(D_METHOD("get_ik_bone", "bone"), &IKBoneSegment3D::get_ik_bone);
 }
 
@@ -263,6 +524,12 @@ IKBoneSegment3D::IKBoneSegment3D(Skeleton3D *p_skeleton, StringName p_root_bone_
 	default_stabilizing_pass_count = p_stabilizing_pass_count;
 }
 
+IKBoneSegment3D::~IKBoneSegment3D() {
+	if (solver_backend) {
+		memdelete(solver_backend);
+	}
+}
+
 void IKBoneSegment3D::_enable_pinned_descendants() {
 	pinned_descendants = true;
 }
@@ -313,7 +580,10 @@ void IKBoneSegment3D::recursive_create_penalty_array(Ref<IKBoneSegment3D> p_bone
 
 	double current_falloff = 1.0;
 
-	if (p_bone_segment->is_pinned()) {
+	// Pins rooted below this segment or skipped by the LOD are left out, matching its effector list, but still damp what they propagate.
+	if (p_bone_segment->is_pinned() && !_is_pin_solved(p_bone_segment->get_tip()->get_pin())) {
+		current_falloff = p_bone_segment->get_tip()->get_pin()->get_motion_propagation_factor();
+	} else if (p_bone_segment->is_pinned()) {
 		Ref<IKBone3D> current_tip = p_bone_segment->get_tip();
 		Ref<IKEffector3D> pin = current_tip->get_pin();
 		double weight = pin->get_weight();
@@ -355,8 +625,10 @@ void IKBoneSegment3D::generate_default_segments(Vector<Ref<IKEffectorTemplate3D>
 
 	while (!_is_parent_of_tip(current_tip, p_tip_bone)) {
 		children = skeleton->get_bone_children(current_tip->get_bone_id());
+		// A lone child outside the solver's scope ends the segment, and one that is a pin's root bone starts the next.
+		const bool child_breaks_segment = p_many_bone_ik && children.size() == 1 && (!p_many_bone_ik->is_bone_in_scope(children[0]) || p_many_bone_ik->is_bone_pin_root(children[0]));
 
-		if (children.is_empty() || _has_multiple_children_or_pinned(children, current_tip)) {
+		if (children.is_empty() || child_breaks_segment || _has_multiple_children_or_pinned(children, current_tip)) {
 			_process_children(children, current_tip, p_pins, p_root_bone, p_tip_bone, p_many_bone_ik);
 			break;
 		} else {
@@ -366,12 +638,46 @@ void IKBoneSegment3D::generate_default_segments(Vector<Ref<IKEffectorTemplate3D>
 	}
 
 	_finalize_segment(current_tip);
+	two_bone_chain = p_many_bone_ik && p_many_bone_ik->get_two_bone_fast_path() && _is_two_bone_chain();
+	if (p_many_bone_ik) {
+		solver_backend_type = p_many_bone_ik->get_segment_solver_backend(root->get_name());
+		if (solver_backend) {
+			memdelete(solver_backend);
+		}
+		solver_backend = IKSolverBackend3D::create(solver_backend_type);
+		jacobi_update = p_many_bone_ik->get_bone_update_mode() == EWBIK3D::BONE_UPDATE_JACOBI;
+		jacobi_relaxation = p_many_bone_ik->get_jacobi_relaxation();
+	}
 }
 
 bool IKBoneSegment3D::_is_parent_of_tip(Ref<IKBone3D> p_current_tip, BoneId p_tip_bone) {
 	return skeleton->get_bone_parent(p_current_tip->get_bone_id()) >= p_tip_bone && p_tip_bone != -1;
 }
 
+bool IKBoneSegment3D::_is_pin_in_scope(const Ref<IKEffector3D> &p_pin) const {
+	const BoneId pin_root = p_pin->get_root_bone_id();
+	if (pin_root == -1) {
+		return true;
+	}
+	for (BoneId bone = root->get_bone_id(); bone != -1; bone = skeleton->get_bone_parent(bone)) {
+		if (bone == pin_root) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IKBoneSegment3D::_is_pin_solved(const Ref<IKEffector3D> &p_pin) const {
+	return !p_pin->is_lod_skipped() && _is_pin_in_scope(p_pin);
+}
+
+void IKBoneSegment3D::update_solved_pins() {
+	// Rebuilds the effector lists and heading arrays of this segment tree, keeping its bones.
+	Vector<Vector<double>> weights;
+	update_pinned_list(weights);
+	recursive_create_headings_arrays_for(this);
+}
+
 bool IKBoneSegment3D::_has_multiple_children_or_pinned(Vector<BoneId> &r_children, Ref<IKBone3D> p_current_tip) {
 	return r_children.size() > 1 || p_current_tip->is_pinned();
 }
@@ -382,6 +688,10 @@ void IKBoneSegment3D::_process_children(Vector<BoneId> &r_children, Ref<IKBone3D
 
 	for (int32_t child_i = 0; child_i < r_children.size(); child_i++) {
 		BoneId child_bone = r_children[child_i];
+		if (p_many_bone_ik && !p_many_bone_ik->is_bone_in_scope(child_bone)) {
+			// No pin in scope below it, so nothing there is built.
+			continue;
+		}
 		String child_name = skeleton->get_bone_name(child_bone);
 		Ref<IKBoneSegment3D> child_segment = _create_child_segment(child_name, r_pins, p_root_bone, p_tip_bone, p_many_bone_ik, parent);
 
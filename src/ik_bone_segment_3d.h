@@ -33,10 +33,12 @@
 #include "ik_bone_3d.h"
 #include "ik_effector_3d.h"
 #include "ik_effector_template_3d.h"
+#include "ik_solver_backend_3d.h"
 #include "math/qcp.h"
 #include "scene/3d/skeleton_3d.h"
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "core/object/ref_counted.h"
 
 class IKEffector3D;
@@ -45,6 +47,10 @@ class IKLimitCone3D;
 
 class IKBoneSegment3D : public Resource {
 	GDCLASS(IKBoneSegment3D, Resource);
+	friend class IKQCPSolverBackend3D;
+	friend class IKFABRIKSolverBackend3D;
+	friend class IKDampedLeastSquaresSolverBackend3D;
+
 	Ref<IKBone3D> root;
 	Ref<IKBone3D> tip;
 	Vector<Ref<IKBone3D>> bones;
@@ -61,16 +67,41 @@ class IKBoneSegment3D : public Resource {
 	bool pinned_descendants = false;
 	double previous_deviation = INFINITY;
 	int32_t default_stabilizing_pass_count = 0; // Move to the stabilizing pass to the ik solver. Set it free.
+	bool stabilization_enabled = true; // Cleared by the coarser EWBIK3D LOD tiers.
+	bool frozen = false; // Skipped by the solver, keeping the pose it had, at the coarsest EWBIK3D LOD tiers.
+	bool solve_pending = true; // Cleared for segments that see no moved target, when EWBIK3D solves partially.
+	bool two_bone_chain = false; // Two bones ending in this segment's only pin, solved in closed form.
+	bool two_bone_chain_constrained = false; // Set when the kusudamas rejected the closed form this frame.
+	int32_t solver_backend_type = 0; // An EWBIK3D::SolverBackend.
+	IKSolverBackend3D *solver_backend = nullptr;
+	bool jacobi_update = false; // Every bone fits against the same snapshot, then all rotations are applied together.
+	float jacobi_relaxation = 1.0f;
+	Vector<PackedVector3Array> jacobi_tip_headings; // One scratch heading set per bone, so bones can be fitted in parallel.
+	Vector<PackedVector3Array> jacobi_target_headings;
+	LocalVector<Vector3> jacobi_batch_tip_headings; // The same headings interleaved by bone for the batched QCP.
+	LocalVector<Vector3> jacobi_batch_target_headings;
+	LocalVector<Quaternion> jacobi_rotations;
+	static constexpr int32_t JACOBI_BLOCK_SIZE = QuaternionCharacteristicPolynomial::BATCH_LANES * 4; // Bones per batched QCP task.
 	bool _has_pinned_descendants();
 	void _enable_pinned_descendants();
 	void _update_target_headings(Ref<IKBone3D> p_for_bone, Vector<double> *r_weights, PackedVector3Array *r_htarget);
 	void _update_tip_headings(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_heading_tip);
 	void _set_optimal_rotation(Ref<IKBone3D> p_for_bone, PackedVector3Array *r_htip, PackedVector3Array *r_heading_tip, Vector<double> *r_weights, float p_dampening = -1, bool p_translate = false, bool p_constraint_mode = false, double current_iteration = 0, double total_iterations = 0);
+	void _solve_with_backend(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations);
 	void _qcp_solver(const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations);
+	void _qcp_jacobi_solver(const Vector<float> &p_damp, float p_default_damp);
+	void _gather_bone_headings(uint32_t p_bone_index, int32_t p_bone_count);
+	void _solve_jacobi_block(uint32_t p_block_index, int32_t p_bone_count);
 	void _update_optimal_rotation(Ref<IKBone3D> p_for_bone, double p_damp, bool p_translate, bool p_constraint_mode, int32_t current_iteration, int32_t total_iterations);
-	float _get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights);
+	float _get_bone_damp(const Ref<IKBone3D> &p_for_bone, const Vector<float> &p_damp, float p_default_damp) const;
+	void _snap_to_constraints(const Ref<IKBone3D> &p_for_bone);
+	bool _is_two_bone_chain() const;
+	bool _solve_two_bone_chain(const Vector<float> &p_damp, float p_default_damp, int32_t p_current_iteration, int32_t p_total_iterations);
+	double _get_manual_msd(const PackedVector3Array &r_htip, const PackedVector3Array &r_htarget, const Vector<double> &p_weights);
 	HashMap<BoneId, Ref<IKBone3D>> bone_map;
 	bool _is_parent_of_tip(Ref<IKBone3D> p_current_tip, BoneId p_tip_bone);
+	bool _is_pin_in_scope(const Ref<IKEffector3D> &p_pin) const;
+	bool _is_pin_solved(const Ref<IKEffector3D> &p_pin) const;
 	bool _has_multiple_children_or_pinned(Vector<BoneId> &r_children, Ref<IKBone3D> p_current_tip);
 	void _process_children(Vector<BoneId> &r_children, Ref<IKBone3D> p_current_tip, Vector<Ref<IKEffectorTemplate3D>> &r_pins, BoneId p_root_bone, BoneId p_tip_bone, EWBIK3D *p_many_bone_ik);
 	Ref<IKBoneSegment3D> _create_child_segment(String &p_child_name, Vector<Ref<IKEffectorTemplate3D>> &p_pins, BoneId p_root_bone, BoneId p_tip_bone, EWBIK3D *p_many_bone_ik, Ref<IKBoneSegment3D> &p_parent);
@@ -83,6 +114,7 @@ protected:
 public:
 	const double evec_prec = static_cast<double>(1E-6);
 	void update_pinned_list(Vector<Vector<double>> &r_weights);
+	void update_solved_pins();
 	static Quaternion clamp_to_cos_half_angle(Quaternion p_quat, double p_cos_half_angle);
 	static void recursive_create_headings_arrays_for(Ref<IKBoneSegment3D> p_bone_segment);
 	void create_headings_arrays();
@@ -91,6 +123,13 @@ public:
 	Ref<IKBone3D> get_root() const;
 	Ref<IKBone3D> get_tip() const;
 	bool is_pinned() const;
+	bool is_two_bone_chain() const;
+	bool is_jacobi_update() const;
+	void set_lod(bool p_stabilization_enabled, int32_t p_freeze_depth, int32_t p_depth = 0);
+	bool is_frozen() const;
+	int32_t update_solve_pending(bool p_all);
+	bool is_solve_pending() const;
+	int32_t get_solver_backend() const;
 	Vector<Ref<IKBoneSegment3D>> get_child_segments() const;
 	void create_bone_list(Vector<Ref<IKBone3D>> &p_list, bool p_recursive = false) const;
 	Ref<IKBone3D> get_ik_bone(BoneId p_bone) const;
@@ -98,5 +137,5 @@ public:
 	IKBoneSegment3D() {}
 	IKBoneSegment3D(Skeleton3D *p_skeleton, StringName p_root_bone_name, Vector<Ref<IKEffectorTemplate3D>> &p_pins, EWBIK3D *p_many_bone_ik, const Ref<IKBoneSegment3D> &p_parent = nullptr,
 			BoneId root = -1, BoneId tip = -1, int32_t p_stabilizing_pass_count = 0);
-	~IKBoneSegment3D() {}
+	~IKBoneSegment3D();
 };
@@ -44,6 +44,8 @@
 void IKEffector3D::set_target_node(Skeleton3D *p_skeleton, const NodePath &p_target_node_path) {
 	ERR_FAIL_NULL(p_skeleton);
 	target_node_path = p_target_node_path;
+	target_node_cache = ObjectID();
+	target_node_transform_valid = false;
 }
 
 NodePath IKEffector3D::get_target_node() const {
@@ -74,19 +76,66 @@ Vector3 IKEffector3D::get_direction_priorities() const {
 	return direction_priorities;
 }
 
-void IKEffector3D::update_target_global_transform(Skeleton3D *p_skeleton, EWBIK3D *p_many_bone_ik) {
-	ERR_FAIL_NULL(p_skeleton);
-	ERR_FAIL_COND(for_bone.is_null());
-	Node3D *current_target_node = cast_to<Node3D>(p_many_bone_ik->get_node_or_null(target_node_path));
-	if (current_target_node && current_target_node->is_visible_in_tree()) {
-		target_relative_to_skeleton_origin = p_skeleton->get_global_transform().affine_inverse() * current_target_node->get_global_transform();
+bool IKEffector3D::update_target_global_transform(const Transform3D &p_to_skeleton, bool p_skeleton_moved, EWBIK3D *p_many_bone_ik) {
+	ERR_FAIL_NULL_V(p_many_bone_ik, false);
+	ERR_FAIL_COND_V(for_bone.is_null(), false);
+	if (use_target_transform) {
+		if (!target_transform_world || !p_skeleton_moved) {
+			return false;
+		}
+		// A world target holds still while the skeleton moves under it.
+		const Transform3D target = p_to_skeleton * target_transform;
+		if (target == target_relative_to_skeleton_origin) {
+			return false;
+		}
+		target_relative_to_skeleton_origin = target;
+		return true;
+	}
+	// The node is looked up by path only when the cached one is gone or left the tree.
+	Node3D *current_target_node = cast_to<Node3D>(ObjectDB::get_instance(target_node_cache));
+	if (!current_target_node || !current_target_node->is_inside_tree()) {
+		current_target_node = cast_to<Node3D>(p_many_bone_ik->get_node_or_null(target_node_path));
+		target_node_cache = current_target_node ? current_target_node->get_instance_id() : ObjectID();
 	}
+	if (!current_target_node || !current_target_node->is_visible_in_tree()) {
+		target_node_transform_valid = false;
+		return false;
+	}
+	const Transform3D node_transform = current_target_node->get_global_transform();
+	if (target_node_transform_valid && !p_skeleton_moved && node_transform == target_node_transform) {
+		return false;
+	}
+	target_node_transform = node_transform;
+	target_node_transform_valid = true;
+	const Transform3D target = p_to_skeleton * node_transform;
+	if (target == target_relative_to_skeleton_origin) {
+		// The node moved along with the skeleton.
+		return false;
+	}
+	target_relative_to_skeleton_origin = target;
+	return true;
 }
 
 Transform3D IKEffector3D::get_target_global_transform() const {
 	return target_relative_to_skeleton_origin;
 }
 
+void IKEffector3D::set_target_transform(const Transform3D &p_transform, bool p_world, const Transform3D &p_to_skeleton) {
+	target_transform = p_transform;
+	target_transform_world = p_world;
+	target_relative_to_skeleton_origin = p_world ? p_to_skeleton * p_transform : p_transform;
+	use_target_transform = true;
+}
+
+void IKEffector3D::clear_target_transform() {
+	use_target_transform = false;
+	target_node_transform_valid = false;
+}
+
+bool IKEffector3D::is_using_target_transform() const {
+	return use_target_transform;
+}
+
 int32_t IKEffector3D::update_effector_target_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone, const Vector<double> *p_weights) const {
 	ERR_FAIL_COND_V(p_index == -1, -1);
 	ERR_FAIL_NULL_V(p_headings, -1);
@@ -127,8 +176,7 @@ int32_t IKEffector3D::update_effector_tip_headings(PackedVector3Array *p_heading
 	int32_t index = p_index;
 	p_headings->write[index] = tip_xform_relative_to_skeleton_origin.origin - bone_origin_relative_to_skeleton_origin;
 	index++;
-	double distance = target_relative_to_skeleton_origin.origin.distance_to(bone_origin_relative_to_skeleton_origin);
-	double scale_by = MIN(distance, 1.0f);
+	double scale_by = get_tip_heading_scale(bone_origin_relative_to_skeleton_origin);
 	const Vector3 priority = get_direction_priorities();
 
 	for (int axis = Vector3::AXIS_X; axis <= Vector3::AXIS_Z; ++axis) {
@@ -148,6 +196,10 @@ int32_t IKEffector3D::update_effector_tip_headings(PackedVector3Array *p_heading
 	return index;
 }
 
+double IKEffector3D::get_tip_heading_scale(const Vector3 &p_bone_origin) const {
+	return MIN(target_relative_to_skeleton_origin.origin.distance_to(p_bone_origin), 1.0f);
+}
+
 void IKEffector3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_target_node", "skeleton", "node"),
 			&IKEffector3D::set_target_node);
@@ -51,9 +51,16 @@ class IKEffector3D : public Resource {
 	ObjectID target_node_cache;
 	Node *target_node_reference = nullptr;
 	bool target_static = false;
-	Transform3D target_transform;
+	Transform3D target_transform; // As it was set; world targets are converted again whenever the skeleton moves.
+	bool use_target_transform = false;
+	bool target_transform_world = false;
 
 	Transform3D target_relative_to_skeleton_origin;
+	Transform3D target_node_transform; // The target node's global transform when it was last read.
+	bool target_node_transform_valid = false;
+	bool target_moved = true; // Since the last solve; only the segments that see a moved target run a partial solve.
+	BoneId root_bone_id = -1; // Segments rooted above this bone leave the pin out.
+	bool lod_skipped = false; // Left out of every segment's headings at the coarser EWBIK3D LOD tiers.
 	int32_t num_headings = 7;
 	// See IKEffectorTemplate to change the defaults.
 	real_t weight = 0.0;
@@ -72,18 +79,34 @@ public:
 	real_t get_weight() const;
 	void set_direction_priorities(Vector3 p_direction_priorities);
 	Vector3 get_direction_priorities() const;
-	void update_target_global_transform(Skeleton3D *p_skeleton, EWBIK3D *p_modification = nullptr);
+	// Returns true when the target relative to the skeleton changed since the last read.
+	bool update_target_global_transform(const Transform3D &p_to_skeleton, bool p_skeleton_moved, EWBIK3D *p_modification);
 	const float MAX_KUSUDAMA_OPEN_CONES = 30;
 	float get_motion_propagation_factor() const;
 	void set_motion_propagation_factor(float p_motion_propagation_factor);
 	void set_target_node(Skeleton3D *p_skeleton, const NodePath &p_target_node_path);
 	NodePath get_target_node() const;
 	Transform3D get_target_global_transform() const;
+	// Drives the target from a transform instead of the target node, until cleared.
+	// A world transform is brought into skeleton space with p_to_skeleton, the inverse of the skeleton's global transform.
+	void set_target_transform(const Transform3D &p_transform, bool p_world = false, const Transform3D &p_to_skeleton = Transform3D());
+	void clear_target_transform();
+	bool is_using_target_transform() const;
+	Transform3D get_target_transform() const { return target_transform; }
+	bool is_target_transform_world() const { return target_transform_world; }
+	void set_target_moved(bool p_moved) { target_moved = p_moved; }
+	bool is_target_moved() const { return target_moved; }
+	void set_root_bone_id(BoneId p_bone) { root_bone_id = p_bone; }
+	BoneId get_root_bone_id() const { return root_bone_id; }
+	void set_lod_skipped(bool p_skipped) { lod_skipped = p_skipped; }
+	bool is_lod_skipped() const { return lod_skipped; }
 	void set_target_node_rotation(bool p_use);
 	bool get_target_node_rotation() const;
 	Ref<IKBone3D> get_ik_bone_3d() const;
 	bool is_following_translation_only() const;
 	int32_t update_effector_target_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone, const Vector<double> *p_weights) const;
 	int32_t update_effector_tip_headings(PackedVector3Array *p_headings, int32_t p_index, Ref<IKBone3D> p_for_bone) const;
+	// The tip's axis headings shrink by this much when the target is closer than a unit to the bone they are fitted for.
+	double get_tip_heading_scale(const Vector3 &p_bone_origin) const;
 	IKEffector3D(const Ref<IKBone3D> &p_current_bone);
 };
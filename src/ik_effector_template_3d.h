@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/io/resource.h"
+#include "core/math/transform_3d.h"
 #include "core/string/node_path.h"
 
 class IKEffectorTemplate3D : public Resource {
@@ -42,6 +43,10 @@ class IKEffectorTemplate3D : public Resource {
 	real_t motion_propagation_factor = 0.0f;
 	real_t weight = 1.0f;
 	Vector3 priority_direction = Vector3(0.2f, 0.0f, 0.2f); // Purported ideal values are 1.0 / 3.0 for one direction, 1.0 / 5.0 for two directions and 1.0 / 7.0 for three directions.
+	// Runtime target fed directly by EWBIK3D; it replaces target_node while set and is not saved.
+	bool target_transform_enabled = false;
+	bool target_transform_world = false; // Global rather than skeleton space, so it stays put when the skeleton moves.
+	Transform3D target_transform;
 protected:
 	static void _bind_methods();
 
@@ -56,6 +61,15 @@ public:
 	void set_weight(real_t p_weight) { weight = p_weight; }
 	Vector3 get_direction_priorities() const { return priority_direction; }
 	void set_direction_priorities(Vector3 p_priority_direction) { priority_direction = p_priority_direction; }
+	bool is_target_transform_enabled() const { return target_transform_enabled; }
+	bool is_target_transform_world() const { return target_transform_world; }
+	Transform3D get_target_transform() const { return target_transform; }
+	void set_target_transform(const Transform3D &p_transform, bool p_world = false) {
+		target_transform = p_transform;
+		target_transform_world = p_world;
+		target_transform_enabled = true;
+	}
+	void clear_target_transform() { target_transform_enabled = false; }
 
 	IKEffectorTemplate3D();
 };
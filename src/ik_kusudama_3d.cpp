@@ -31,6 +31,7 @@
 #include "ik_kusudama_3d.h"
 
 #include "core/math/quaternion.h"
+#include "core/object/worker_thread_pool.h"
 #include "ik_open_cone_3d.h"
 #include "math/ik_node_3d.h"
 #include "math/interval_math.h"
@@ -295,7 +296,7 @@ Vector3 IKKusudama3D::get_local_point_in_limits(Vector3 in_point, Vector<double>
 
 	// Loop through each limit cone
 	for (int i = 0; i < open_cones.size(); i++) {
-		Ref<IKLimitCone3D> cone = open_cones[i];
+		const Ref<IKLimitCone3D> &cone = open_cones[i];
 		Vector3 collision_point = cone->closest_to_cone(point, in_bounds);
 
 		// If the collision point is NaN, return the original point
@@ -317,8 +318,8 @@ Vector3 IKKusudama3D::get_local_point_in_limits(Vector3 in_point, Vector<double>
 	// If we're out of bounds of all cones, check if we're in the paths between the cones
 	if ((*in_bounds)[0] == -1) {
 		for (int i = 0; i < open_cones.size() - 1; i++) {
-			Ref<IKLimitCone3D> currCone = open_cones[i];
-			Ref<IKLimitCone3D> nextCone = open_cones[i + 1];
+			const Ref<IKLimitCone3D> &currCone = open_cones[i];
+			const Ref<IKLimitCone3D> &nextCone = open_cones[i + 1];
 			Vector3 collision_point = currCone->get_on_great_tangent_triangle(nextCone, point);
 
 			// If the collision point is NaN, skip to the next iteration
@@ -346,6 +347,56 @@ Vector3 IKKusudama3D::get_local_point_in_limits(Vector3 in_point, Vector<double>
 	return closest_collision_point;
 }
 
+void IKKusudama3D::_local_points_in_limits_chunk(uint32_t p_chunk, LocalPointsInLimitsBatch *p_batch) {
+	const int32_t begin = p_chunk * LOCAL_POINTS_CHUNK_SIZE;
+	const int32_t end = MIN(begin + LOCAL_POINTS_CHUNK_SIZE, p_batch->point_count);
+	Vector<double> bounds;
+	bounds.resize(2);
+	for (int32_t point_i = begin; point_i < end; point_i++) {
+		bounds.write[0] = -1.0;
+		bounds.write[1] = 0.0;
+		p_batch->limited_points[point_i] = get_local_point_in_limits(p_batch->points[point_i], &bounds);
+		p_batch->in_bounds[point_i] = bounds[0] >= 0.0 ? 1 : 0;
+	}
+}
+
+void IKKusudama3D::get_local_points_in_limits(const PackedVector3Array &p_points, PackedByteArray &r_in_bounds, PackedVector3Array &r_limited_points) {
+	const int32_t point_count = p_points.size();
+	r_in_bounds.resize(point_count);
+	r_limited_points.resize(point_count);
+	if (point_count == 0) {
+		return;
+	}
+
+	LocalPointsInLimitsBatch batch;
+	batch.points = p_points.ptr();
+	batch.in_bounds = r_in_bounds.ptrw();
+	batch.limited_points = r_limited_points.ptrw();
+	batch.point_count = point_count;
+
+	const int32_t chunk_count = (point_count + LOCAL_POINTS_CHUNK_SIZE - 1) / LOCAL_POINTS_CHUNK_SIZE;
+	if (point_count < LOCAL_POINTS_PARALLEL_THRESHOLD) {
+		for (int32_t chunk_i = 0; chunk_i < chunk_count; chunk_i++) {
+			_local_points_in_limits_chunk(chunk_i, &batch);
+		}
+		return;
+	}
+
+	// The cones are only read here, so every chunk can run against the same kusudama.
+	WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &IKKusudama3D::_local_points_in_limits_chunk, &batch, chunk_count, -1, true, SNAME("IKKusudama3D::get_local_points_in_limits"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+}
+
+Dictionary IKKusudama3D::_get_local_points_in_limits_bind(const PackedVector3Array &p_points) {
+	PackedByteArray in_bounds;
+	PackedVector3Array limited_points;
+	get_local_points_in_limits(p_points, in_bounds, limited_points);
+	Dictionary result;
+	result["in_bounds"] = in_bounds;
+	result["points"] = limited_points;
+	return result;
+}
+
 Vector3 IKKusudama3D::_solve(const Vector3 &p_direction) const {
 	// If constraints are disabled, return the original direction
 	if (!is_enabled() || !is_orientationally_constrained()) {
@@ -369,6 +420,7 @@ Vector3 IKKusudama3D::_solve(const Vector3 &p_direction) const {
 void IKKusudama3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_open_cones"), &IKKusudama3D::get_open_cones);
 	ClassDB::bind_method(D_METHOD("set_open_cones", "open_cones"), &IKKusudama3D::set_open_cones);
+	ClassDB::bind_method(D_METHOD("get_local_points_in_limits", "points"), &IKKusudama3D::_get_local_points_in_limits_bind);
 }
 
 void IKKusudama3D::set_open_cones(TypedArray<IKLimitCone3D> p_cones) {
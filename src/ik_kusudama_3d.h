@@ -39,6 +39,7 @@
 #include "core/io/resource.h"
 #include "core/math/quaternion.h"
 #include "core/object/ref_counted.h"
+#include "core/variant/dictionary.h"
 #include "core/variant/typed_array.h"
 #include "scene/3d/node_3d.h"
 
@@ -79,6 +80,20 @@ class IKKusudama3D : public Resource {
 	bool orientationally_constrained = false;
 	bool axially_constrained = false;
 
+	// Batches smaller than this are evaluated on the calling thread.
+	static constexpr int32_t LOCAL_POINTS_PARALLEL_THRESHOLD = 1024;
+	static constexpr int32_t LOCAL_POINTS_CHUNK_SIZE = 256;
+
+	struct LocalPointsInLimitsBatch {
+		const Vector3 *points = nullptr;
+		uint8_t *in_bounds = nullptr;
+		Vector3 *limited_points = nullptr;
+		int32_t point_count = 0;
+	};
+
+	void _local_points_in_limits_chunk(uint32_t p_chunk, LocalPointsInLimitsBatch *p_batch);
+	Dictionary _get_local_points_in_limits_bind(const PackedVector3Array &p_points);
+
 protected:
 	static void _bind_methods();
 
@@ -166,6 +181,13 @@ public:
 	 */
 	Vector3 get_local_point_in_limits(Vector3 in_point, Vector<double> *in_bounds);
 
+	/**
+	 * Batched form of get_local_point_in_limits for tools and validation. Evaluates every point of p_points
+	 * and writes, for each one, 1 into r_in_bounds if it was already within the limits (0 otherwise)
+	 * and the in-limits direction into r_limited_points. Large batches are split across the WorkerThreadPool.
+	 */
+	void get_local_points_in_limits(const PackedVector3Array &p_points, PackedByteArray &r_in_bounds, PackedVector3Array &r_limited_points);
+
 	Vector3 local_point_on_path_sequence(Vector3 in_point, Ref<IKNode3D> limiting_axes);
 
 	/**
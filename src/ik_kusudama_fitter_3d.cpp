@@ -0,0 +1,486 @@
+/**************************************************************************/
+/*  ik_kusudama_fitter_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_kusudama_fitter_3d.h"
+
+#include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "ik_open_cone_3d.h"
+#include "many_bone_ik_3d.h"
+
+void IKKusudamaFitter3D::begin(int32_t p_bone_count) {
+	ERR_FAIL_COND(p_bone_count < 0);
+	bone_count = p_bone_count;
+	bone_fits.clear();
+	bone_fits.resize(bone_count);
+	for (BoneFit &fit : bone_fits) {
+		fit.cone_centers.reserve(max_open_cones);
+		fit.cone_radii.reserve(max_open_cones);
+		fit.cone_radius_cosines.reserve(max_open_cones);
+		fit.cone_sample_counts.reserve(max_open_cones);
+	}
+	bone_directions.resize(bone_count);
+	constraint_orientations.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		bone_directions[bone_i] = Vector3(0.0f, 1.0f, 0.0f);
+		constraint_orientations[bone_i] = Basis();
+	}
+}
+
+void IKKusudamaFitter3D::begin_for(EWBIK3D *p_many_bone_ik) {
+	ERR_FAIL_NULL(p_many_bone_ik);
+	Skeleton3D *skeleton = p_many_bone_ik->get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	begin(skeleton->get_bone_count());
+	const Vector<Ref<IKBone3D>> ik_bones = p_many_bone_ik->get_bone_list();
+	for (const Ref<IKBone3D> &ik_bone : ik_bones) {
+		if (ik_bone.is_null() || ik_bone->get_bone_id() < 0 || ik_bone->get_bone_id() >= bone_count) {
+			continue;
+		}
+		// Both are local: the bone direction to the bone, the orientation to its parent.
+		const Vector3 direction = ik_bone->get_bone_direction_transform()->get_transform().basis.get_column(Vector3::AXIS_Y);
+		if (!direction.is_zero_approx()) {
+			bone_directions[ik_bone->get_bone_id()] = direction.normalized();
+		}
+		constraint_orientations[ik_bone->get_bone_id()] = ik_bone->get_constraint_orientation_transform()->get_transform().basis.orthonormalized();
+	}
+}
+
+int32_t IKKusudamaFitter3D::get_bone_count() const {
+	return bone_count;
+}
+
+void IKKusudamaFitter3D::set_max_open_cones(int32_t p_count) {
+	max_open_cones = CLAMP(p_count, 1, 10);
+}
+
+int32_t IKKusudamaFitter3D::get_max_open_cones() const {
+	return max_open_cones;
+}
+
+void IKKusudamaFitter3D::set_cone_split_angle(real_t p_angle) {
+	cone_split_angle = MAX(p_angle, 0.0f);
+}
+
+real_t IKKusudamaFitter3D::get_cone_split_angle() const {
+	return cone_split_angle;
+}
+
+void IKKusudamaFitter3D::set_min_cone_radius(real_t p_radius) {
+	min_cone_radius = CLAMP(p_radius, 0.0f, real_t(Math::PI));
+}
+
+real_t IKKusudamaFitter3D::get_min_cone_radius() const {
+	return min_cone_radius;
+}
+
+void IKKusudamaFitter3D::set_cone_margin(real_t p_margin) {
+	cone_margin = MAX(p_margin, 0.0f);
+}
+
+real_t IKKusudamaFitter3D::get_cone_margin() const {
+	return cone_margin;
+}
+
+void IKKusudamaFitter3D::_grow_cap(Vector3 &r_center, double &r_radius, double &r_radius_cosine, const Vector3 &p_direction, double p_angle) {
+	// Grow the cap into the smallest cap that holds both the old cap and the new direction,
+	// so every direction seen before stays covered without having to be revisited.
+	const double new_radius = MIN(0.5 * (r_radius + p_angle), double(Math::PI));
+	Vector3 axis = r_center.cross(p_direction);
+	if (axis.length_squared() < CMP_EPSILON2) {
+		axis = IKLimitCone3D::get_orthogonal(r_center);
+	}
+	r_center = Quaternion(axis.normalized(), new_radius - r_radius).xform(r_center).normalized();
+	r_radius = new_radius;
+	// Keep the inside test conservative against rounding in the rotated center.
+	r_radius_cosine = Math::cos(MIN(new_radius + CMP_EPSILON, double(Math::PI)));
+}
+
+void IKKusudamaFitter3D::_accumulate_direction(BoneFit &r_fit, const Vector3 &p_direction) const {
+	const int32_t cone_count = r_fit.cone_centers.size();
+	int32_t nearest = -1;
+	double nearest_gap = Math::INF;
+	double nearest_angle = 0.0;
+	for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+		const double cosine = r_fit.cone_centers[cone_i].dot(p_direction);
+		if (cosine >= r_fit.cone_radius_cosines[cone_i]) {
+			r_fit.cone_sample_counts[cone_i]++;
+			return;
+		}
+		const double angle = Math::acos(CLAMP(cosine, -1.0, 1.0));
+		const double gap = angle - r_fit.cone_radii[cone_i];
+		if (gap < nearest_gap) {
+			nearest = cone_i;
+			nearest_gap = gap;
+			nearest_angle = angle;
+		}
+	}
+
+	if (nearest == -1 || (cone_count < max_open_cones && nearest_gap > cone_split_angle)) {
+		r_fit.cone_centers.push_back(p_direction);
+		r_fit.cone_radii.push_back(0.0);
+		r_fit.cone_radius_cosines.push_back(1.0);
+		r_fit.cone_sample_counts.push_back(1);
+		return;
+	}
+
+	_grow_cap(r_fit.cone_centers[nearest], r_fit.cone_radii[nearest], r_fit.cone_radius_cosines[nearest], p_direction, nearest_angle);
+	r_fit.cone_sample_counts[nearest]++;
+}
+
+void IKKusudamaFitter3D::_accumulate_twist(BoneFit &r_fit, double p_twist, const Vector3 &p_axis) const {
+	if (r_fit.sample_count == 1) {
+		r_fit.twist_reference = p_twist;
+		r_fit.twist_low = 0.0;
+		r_fit.twist_high = 0.0;
+		r_fit.twist_axis_center = p_axis;
+		r_fit.twist_axis_radius = 0.0;
+		r_fit.twist_axis_radius_cosine = 1.0;
+		return;
+	}
+	const double delta = Math::wrapf(p_twist - r_fit.twist_reference, -Math::PI, Math::PI);
+	r_fit.twist_low = MIN(r_fit.twist_low, delta);
+	r_fit.twist_high = MAX(r_fit.twist_high, delta);
+	const double cosine = r_fit.twist_axis_center.dot(p_axis);
+	if (cosine < r_fit.twist_axis_radius_cosine) {
+		_grow_cap(r_fit.twist_axis_center, r_fit.twist_axis_radius, r_fit.twist_axis_radius_cosine, p_axis, Math::acos(CLAMP(cosine, -1.0, 1.0)));
+	}
+}
+
+void IKKusudamaFitter3D::_accumulate_bone(uint32_t p_bone, const SampleBatch *p_batch) {
+	BoneFit &fit = bone_fits[p_bone];
+	const Vector3 bone_direction = bone_directions[p_bone];
+	const Basis constraint_orientation = constraint_orientations[p_bone];
+	const int64_t stride = int64_t(bone_count) * 4;
+	const float *rotation = p_batch->rotations + int64_t(p_bone) * 4;
+	for (int64_t frame_i = 0; frame_i < p_batch->frame_count; frame_i++, rotation += stride) {
+		Quaternion sample(rotation[0], rotation[1], rotation[2], rotation[3]);
+		const real_t length_squared = sample.length_squared();
+		if (!Math::is_finite(length_squared) || length_squared < CMP_EPSILON2) {
+			continue;
+		}
+		sample /= Math::sqrt(length_squared);
+		fit.sample_count++;
+		_accumulate_direction(fit, constraint_orientation.xform_inv(sample.xform(bone_direction)));
+		// Twist about Y is the angle of the quaternion projected onto the Y axis.
+		_accumulate_twist(fit, 2.0 * Math::atan2(double(sample.y), double(sample.w)), sample.xform(Vector3(0.0f, 1.0f, 0.0f)));
+	}
+}
+
+void IKKusudamaFitter3D::accumulate(const PackedFloat32Array &p_rotations) {
+	ERR_FAIL_COND_MSG(bone_count <= 0, "Call begin() with the skeleton's bone count before accumulating samples.");
+	SampleBatch batch;
+	batch.rotations = p_rotations.ptr();
+	batch.frame_count = p_rotations.size() / (int64_t(bone_count) * 4);
+	if (batch.frame_count == 0) {
+		return;
+	}
+
+	if (bone_count == 1 || batch.frame_count * bone_count < PARALLEL_SAMPLE_THRESHOLD) {
+		for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+			_accumulate_bone(bone_i, &batch);
+		}
+		return;
+	}
+
+	// Each task owns exactly one bone's fit, so the bones never share state.
+	WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &IKKusudamaFitter3D::_accumulate_bone, &batch, bone_count, -1, true, SNAME("IKKusudamaFitter3D::accumulate"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+}
+
+Error IKKusudamaFitter3D::accumulate_file(const String &p_path, int32_t p_frames_per_chunk) {
+	ERR_FAIL_COND_V_MSG(bone_count <= 0, ERR_UNCONFIGURED, "Call begin() with the skeleton's bone count before accumulating samples.");
+	ERR_FAIL_COND_V(p_frames_per_chunk <= 0, ERR_INVALID_PARAMETER);
+	Error err = OK;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err, vformat("Cannot open motion capture file '%s'.", p_path));
+
+	const uint64_t frame_bytes = uint64_t(bone_count) * 4 * sizeof(float);
+	const uint64_t chunk_bytes = frame_bytes * p_frames_per_chunk;
+	PackedFloat32Array chunk;
+	chunk.resize(int64_t(p_frames_per_chunk) * bone_count * 4);
+	while (true) {
+		const uint64_t read_bytes = file->get_buffer(reinterpret_cast<uint8_t *>(chunk.ptrw()), chunk_bytes);
+		const uint64_t frame_count = read_bytes / frame_bytes;
+		if (frame_count == 0) {
+			break;
+		}
+		if (read_bytes < chunk_bytes) {
+			chunk.resize(frame_count * bone_count * 4);
+		}
+		accumulate(chunk);
+		if (read_bytes < chunk_bytes) {
+			break;
+		}
+	}
+	return OK;
+}
+
+Error IKKusudamaFitter3D::accumulate_animation(const Ref<Animation> &p_animation, Skeleton3D *p_skeleton, double p_sample_rate) {
+	ERR_FAIL_COND_V(p_animation.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_NULL_V(p_skeleton, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_sample_rate <= 0.0, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(bone_count != p_skeleton->get_bone_count(), ERR_INVALID_PARAMETER, "The fitter must be started with the skeleton's bone count.");
+
+	LocalVector<int32_t> bone_tracks;
+	LocalVector<Quaternion> pose_rotations;
+	bone_tracks.resize(bone_count);
+	pose_rotations.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		bone_tracks[bone_i] = -1;
+		pose_rotations[bone_i] = p_skeleton->get_bone_pose_rotation(bone_i);
+	}
+	for (int32_t track_i = 0; track_i < p_animation->get_track_count(); track_i++) {
+		if (p_animation->track_get_type(track_i) != Animation::TYPE_ROTATION_3D) {
+			continue;
+		}
+		BoneId bone = p_skeleton->find_bone(p_animation->track_get_path(track_i).get_concatenated_subnames());
+		if (bone >= 0 && bone < bone_count) {
+			bone_tracks[bone] = track_i;
+		}
+	}
+
+	const double length = p_animation->get_length();
+	const int64_t frame_count = int64_t(Math::floor(length * p_sample_rate)) + 1;
+	PackedFloat32Array chunk;
+	for (int64_t chunk_begin = 0; chunk_begin < frame_count; chunk_begin += STREAM_FRAMES_PER_CHUNK) {
+		const int64_t chunk_frames = MIN(int64_t(STREAM_FRAMES_PER_CHUNK), frame_count - chunk_begin);
+		chunk.resize(chunk_frames * bone_count * 4);
+		float *rotations = chunk.ptrw();
+		for (int64_t frame_i = 0; frame_i < chunk_frames; frame_i++) {
+			const double time = MIN((chunk_begin + frame_i) / p_sample_rate, length);
+			for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+				Quaternion rotation = pose_rotations[bone_i];
+				if (bone_tracks[bone_i] != -1) {
+					p_animation->rotation_track_interpolate(bone_tracks[bone_i], time, &rotation);
+				}
+				*rotations++ = rotation.x;
+				*rotations++ = rotation.y;
+				*rotations++ = rotation.z;
+				*rotations++ = rotation.w;
+			}
+		}
+		accumulate(chunk);
+	}
+	return OK;
+}
+
+int64_t IKKusudamaFitter3D::get_sample_count(int32_t p_bone) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), 0);
+	return bone_fits[p_bone].sample_count;
+}
+
+int32_t IKKusudamaFitter3D::get_open_cone_count(int32_t p_bone) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), 0);
+	return bone_fits[p_bone].cone_centers.size();
+}
+
+LocalVector<int32_t> IKKusudamaFitter3D::_get_cone_order(int32_t p_bone) const {
+	// Consecutive cones in a kusudama are joined by tangent paths, so chain each cone to its nearest
+	// unvisited neighbour starting from the most populated one.
+	const BoneFit &fit = bone_fits[p_bone];
+	const int32_t cone_count = fit.cone_centers.size();
+	LocalVector<int32_t> order;
+	LocalVector<bool> visited;
+	order.reserve(cone_count);
+	visited.resize(cone_count);
+	int32_t current = 0;
+	for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+		visited[cone_i] = false;
+		if (fit.cone_sample_counts[cone_i] > fit.cone_sample_counts[current]) {
+			current = cone_i;
+		}
+	}
+	while (current != -1) {
+		order.push_back(current);
+		visited[current] = true;
+		int32_t next = -1;
+		real_t best = -2.0f;
+		for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+			real_t cosine = fit.cone_centers[current].dot(fit.cone_centers[cone_i]);
+			if (!visited[cone_i] && cosine > best) {
+				best = cosine;
+				next = cone_i;
+			}
+		}
+		current = next;
+	}
+	return order;
+}
+
+Vector3 IKKusudamaFitter3D::get_open_cone_center(int32_t p_bone, int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), Vector3(0.0f, 1.0f, 0.0f));
+	ERR_FAIL_INDEX_V(p_index, (int32_t)bone_fits[p_bone].cone_centers.size(), Vector3(0.0f, 1.0f, 0.0f));
+	return bone_fits[p_bone].cone_centers[_get_cone_order(p_bone)[p_index]];
+}
+
+real_t IKKusudamaFitter3D::get_open_cone_radius(int32_t p_bone, int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), Math::PI);
+	ERR_FAIL_INDEX_V(p_index, (int32_t)bone_fits[p_bone].cone_radii.size(), Math::PI);
+	const double radius = bone_fits[p_bone].cone_radii[_get_cone_order(p_bone)[p_index]] + cone_margin;
+	return CLAMP(radius, double(min_cone_radius), double(Math::PI));
+}
+
+Vector2 IKKusudamaFitter3D::get_twist(int32_t p_bone) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), Vector2(0.0f, Math::TAU));
+	const BoneFit &fit = bone_fits[p_bone];
+	if (fit.sample_count == 0) {
+		return Vector2(0.0f, Math::TAU);
+	}
+	const double range = MIN(fit.twist_high - fit.twist_low + 2.0 * cone_margin, double(Math::TAU));
+	const double start = fit.twist_reference + fit.twist_low - cone_margin;
+	return Vector2(Math::wrapf(start, -Math::PI, Math::PI), range);
+}
+
+Ref<IKKusudama3D> IKKusudamaFitter3D::create_kusudama(int32_t p_bone) const {
+	ERR_FAIL_INDEX_V(p_bone, (int32_t)bone_fits.size(), Ref<IKKusudama3D>());
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	if (bone_fits[p_bone].sample_count == 0) {
+		return kusudama;
+	}
+	kusudama->enable_orientational_limits();
+	const int32_t cone_count = get_open_cone_count(p_bone);
+	for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+		Ref<IKLimitCone3D> cone;
+		cone.instantiate();
+		cone->set_attached_to(kusudama);
+		cone->set_radius(MAX(1.0e-38, get_open_cone_radius(p_bone, cone_i)));
+		cone->set_control_point(get_open_cone_center(p_bone, cone_i));
+		kusudama->add_open_cone(cone);
+	}
+	const Vector2 twist = get_twist(p_bone);
+	kusudama->enable_axial_limits();
+	kusudama->set_axial_limits(twist.x, twist.y);
+	return kusudama;
+}
+
+Vector2 IKKusudamaFitter3D::_get_solver_twist(int32_t p_bone, const Ref<IKKusudama3D> &p_kusudama) const {
+	const BoneFit &fit = bone_fits[p_bone];
+	const Vector2 twist = get_twist(p_bone);
+	if (twist.y >= Math::TAU) {
+		return twist;
+	}
+	// The solver points its twist frame at the cones the way a rebuild does: starting from the parent's axes.
+	Ref<IKNode3D> parent_axes;
+	parent_axes.instantiate();
+	Ref<IKNode3D> twist_axes;
+	twist_axes.instantiate();
+	twist_axes->set_parent(parent_axes);
+	p_kusudama->_update_constraint(twist_axes);
+	const Quaternion to_twist_frame = twist_axes->get_transform().basis.get_rotation_quaternion().inverse();
+
+	// A sample's twist in that frame is its twist here plus a term that only depends on its Y axis,
+	// so the range shifts and widens by how far that term moves across the cap of Y axes.
+	const Vector3 up = Vector3(0.0f, 1.0f, 0.0f);
+	const Vector3 center = fit.twist_axis_center;
+	const Vector3 tangent = IKLimitCone3D::get_orthogonal(center).normalized();
+	double offset_reference = 0.0;
+	double offset_low = 0.0;
+	double offset_high = 0.0;
+	const int32_t ring_count = 2;
+	const int32_t ring_point_count = 16;
+	for (int32_t ring_i = 0; ring_i <= ring_count; ring_i++) {
+		const double ring_radius = fit.twist_axis_radius * ring_i / ring_count;
+		const Vector3 ring_start = Quaternion(tangent, ring_radius).xform(center);
+		for (int32_t point_i = 0; point_i < (ring_i == 0 ? 1 : ring_point_count); point_i++) {
+			const Vector3 axis = Quaternion(center, Math::TAU * point_i / ring_point_count).xform(ring_start).normalized();
+			const Quaternion in_twist_frame = to_twist_frame * Quaternion(up, axis);
+			const double offset = 2.0 * Math::atan2(double(in_twist_frame.y), double(in_twist_frame.w));
+			if (ring_i == 0) {
+				offset_reference = offset;
+				continue;
+			}
+			const double delta = Math::wrapf(offset - offset_reference, -Math::PI, Math::PI);
+			offset_low = MIN(offset_low, delta);
+			offset_high = MAX(offset_high, delta);
+		}
+	}
+	const double range = MIN(double(twist.y) + offset_high - offset_low, double(Math::TAU));
+	const double start = twist.x + offset_reference + offset_low;
+	// The solver centers the range on twice the start angle it is given.
+	const double solver_center = Math::wrapf(start + 0.5 * range, -Math::PI, Math::PI);
+	return Vector2(0.5 * solver_center, range);
+}
+
+void IKKusudamaFitter3D::apply(EWBIK3D *p_many_bone_ik) const {
+	ERR_FAIL_NULL(p_many_bone_ik);
+	Skeleton3D *skeleton = p_many_bone_ik->get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	ERR_FAIL_COND_MSG(skeleton->get_bone_count() != bone_count, "The fitter was started with a different bone count than the solver's skeleton.");
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		if (bone_fits[bone_i].sample_count == 0) {
+			continue;
+		}
+		String bone_name = skeleton->get_bone_name(bone_i);
+		int32_t constraint_i = p_many_bone_ik->find_constraint(bone_name);
+		if (constraint_i == -1) {
+			p_many_bone_ik->add_constraint();
+			constraint_i = p_many_bone_ik->get_constraint_count() - 1;
+			p_many_bone_ik->set_constraint_name_at_index(constraint_i, bone_name);
+		}
+		const int32_t cone_count = get_open_cone_count(bone_i);
+		p_many_bone_ik->set_kusudama_open_cone_count(constraint_i, cone_count);
+		for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+			p_many_bone_ik->set_kusudama_open_cone_center(constraint_i, cone_i, get_open_cone_center(bone_i, cone_i));
+			p_many_bone_ik->set_kusudama_open_cone_radius(constraint_i, cone_i, get_open_cone_radius(bone_i, cone_i));
+		}
+		p_many_bone_ik->set_joint_twist(constraint_i, _get_solver_twist(bone_i, create_kusudama(bone_i)));
+	}
+}
+
+void IKKusudamaFitter3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("begin", "bone_count"), &IKKusudamaFitter3D::begin);
+	ClassDB::bind_method(D_METHOD("begin_for", "many_bone_ik"), &IKKusudamaFitter3D::begin_for);
+	ClassDB::bind_method(D_METHOD("get_bone_count"), &IKKusudamaFitter3D::get_bone_count);
+	ClassDB::bind_method(D_METHOD("set_max_open_cones", "count"), &IKKusudamaFitter3D::set_max_open_cones);
+	ClassDB::bind_method(D_METHOD("get_max_open_cones"), &IKKusudamaFitter3D::get_max_open_cones);
+	ClassDB::bind_method(D_METHOD("set_cone_split_angle", "angle"), &IKKusudamaFitter3D::set_cone_split_angle);
+	ClassDB::bind_method(D_METHOD("get_cone_split_angle"), &IKKusudamaFitter3D::get_cone_split_angle);
+	ClassDB::bind_method(D_METHOD("set_min_cone_radius", "radius"), &IKKusudamaFitter3D::set_min_cone_radius);
+	ClassDB::bind_method(D_METHOD("get_min_cone_radius"), &IKKusudamaFitter3D::get_min_cone_radius);
+	ClassDB::bind_method(D_METHOD("set_cone_margin", "margin"), &IKKusudamaFitter3D::set_cone_margin);
+	ClassDB::bind_method(D_METHOD("get_cone_margin"), &IKKusudamaFitter3D::get_cone_margin);
+	ClassDB::bind_method(D_METHOD("accumulate", "rotations"), &IKKusudamaFitter3D::accumulate);
+	ClassDB::bind_method(D_METHOD("accumulate_file", "path", "frames_per_chunk"), &IKKusudamaFitter3D::accumulate_file, DEFVAL(STREAM_FRAMES_PER_CHUNK));
+	ClassDB::bind_method(D_METHOD("accumulate_animation", "animation", "skeleton", "sample_rate"), &IKKusudamaFitter3D::accumulate_animation, DEFVAL(30.0));
+	ClassDB::bind_method(D_METHOD("get_sample_count", "bone"), &IKKusudamaFitter3D::get_sample_count);
+	ClassDB::bind_method(D_METHOD("get_open_cone_count", "bone"), &IKKusudamaFitter3D::get_open_cone_count);
+	ClassDB::bind_method(D_METHOD("get_open_cone_center", "bone", "index"), &IKKusudamaFitter3D::get_open_cone_center);
+	ClassDB::bind_method(D_METHOD("get_open_cone_radius", "bone", "index"), &IKKusudamaFitter3D::get_open_cone_radius);
+	ClassDB::bind_method(D_METHOD("get_twist", "bone"), &IKKusudamaFitter3D::get_twist);
+	ClassDB::bind_method(D_METHOD("create_kusudama", "bone"), &IKKusudamaFitter3D::create_kusudama);
+	ClassDB::bind_method(D_METHOD("apply", "many_bone_ik"), &IKKusudamaFitter3D::apply);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_open_cones", PROPERTY_HINT_RANGE, "1,10,1"), "set_max_open_cones", "get_max_open_cones");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cone_split_angle", PROPERTY_HINT_RANGE, "0,180,0.1,radians"), "set_cone_split_angle", "get_cone_split_angle");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "min_cone_radius", PROPERTY_HINT_RANGE, "0,180,0.1,radians"), "set_min_cone_radius", "get_min_cone_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cone_margin", PROPERTY_HINT_RANGE, "0,45,0.1,radians"), "set_cone_margin", "get_cone_margin");
+}
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*  ik_kusudama_fitter_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "ik_kusudama_3d.h"
+
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/resources/animation.h"
+
+class EWBIK3D;
+
+/**
+ * Fits kusudama open cones and twist ranges to recorded bone orientations.
+ *
+ * Samples are consumed in frame-major blocks of local bone rotations and folded into a small
+ * per-bone state, so the fitter never keeps the samples themselves and a capture can be streamed
+ * through it in as many blocks as needed. Every block is fitted in parallel, one task per bone.
+ */
+class IKKusudamaFitter3D : public RefCounted {
+	GDCLASS(IKKusudamaFitter3D, RefCounted);
+
+	static constexpr int32_t PARALLEL_SAMPLE_THRESHOLD = 4096;
+	static constexpr int32_t STREAM_FRAMES_PER_CHUNK = 1024;
+
+	struct BoneFit {
+		/**
+		 * Bounding caps on the unit sphere of the bone's direction in its constraint's orientation frame.
+		 * Every direction seen so far lies inside at least one of these caps.
+		 */
+		LocalVector<Vector3> cone_centers;
+		LocalVector<double> cone_radii;
+		LocalVector<double> cone_radius_cosines;
+		LocalVector<int64_t> cone_sample_counts;
+		int64_t sample_count = 0;
+		/**
+		 * Twist about the bone's Y axis, measured relative to the first sample so the range
+		 * can be tracked without wrapping around.
+		 */
+		double twist_reference = 0.0;
+		double twist_low = 0.0;
+		double twist_high = 0.0;
+		/**
+		 * One cap around every Y axis the twist was measured about, in the parent's space. The solver
+		 * measures twist from a frame of its own, and apply() widens the range by how far the two
+		 * disagree across this cap.
+		 */
+		Vector3 twist_axis_center;
+		double twist_axis_radius = 0.0;
+		double twist_axis_radius_cosine = 1.0;
+	};
+
+	struct SampleBatch {
+		const float *rotations = nullptr;
+		int64_t frame_count = 0;
+	};
+
+	LocalVector<BoneFit> bone_fits;
+	// The solver's frames for each bone: the bone-space axis it constrains and its constraint's orientation in parent space.
+	LocalVector<Vector3> bone_directions;
+	LocalVector<Basis> constraint_orientations;
+	int32_t bone_count = 0;
+	int32_t max_open_cones = 4;
+	real_t cone_split_angle = Math::deg_to_rad(30.0f);
+	real_t min_cone_radius = Math::deg_to_rad(1.0f);
+	real_t cone_margin = 0.0f;
+
+	void _accumulate_bone(uint32_t p_bone, const SampleBatch *p_batch);
+	static void _grow_cap(Vector3 &r_center, double &r_radius, double &r_radius_cosine, const Vector3 &p_direction, double p_angle);
+	void _accumulate_direction(BoneFit &r_fit, const Vector3 &p_direction) const;
+	void _accumulate_twist(BoneFit &r_fit, double p_twist, const Vector3 &p_axis) const;
+	Vector2 _get_solver_twist(int32_t p_bone, const Ref<IKKusudama3D> &p_kusudama) const;
+	LocalVector<int32_t> _get_cone_order(int32_t p_bone) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void begin(int32_t p_bone_count);
+	/**
+	 * Starts a fit for the skeleton of p_many_bone_ik in the frames its solver constrains each bone in:
+	 * the direction toward the bone's children rather than its Y axis, relative to the constraint's
+	 * orientation. Bones the solver has not built yet keep their Y axis, so run it once first.
+	 */
+	void begin_for(EWBIK3D *p_many_bone_ik);
+	int32_t get_bone_count() const;
+
+	void set_max_open_cones(int32_t p_count);
+	int32_t get_max_open_cones() const;
+	void set_cone_split_angle(real_t p_angle);
+	real_t get_cone_split_angle() const;
+	void set_min_cone_radius(real_t p_radius);
+	real_t get_min_cone_radius() const;
+	void set_cone_margin(real_t p_margin);
+	real_t get_cone_margin() const;
+
+	/**
+	 * Folds a block of frames into the fit.
+	 *
+	 * @param p_rotations frame-major local bone rotations, four floats (x, y, z, w) per bone and
+	 * get_bone_count() bones per frame. A trailing partial frame is ignored.
+	 */
+	void accumulate(const PackedFloat32Array &p_rotations);
+	/**
+	 * Streams a packed capture file through accumulate() without loading it whole.
+	 * The file holds the same frame-major float32 layout as accumulate() and no header.
+	 */
+	Error accumulate_file(const String &p_path, int32_t p_frames_per_chunk = STREAM_FRAMES_PER_CHUNK);
+	/**
+	 * Bakes the rotation tracks of an animation at p_sample_rate and streams the result through
+	 * accumulate(). Bones without a rotation track contribute their current skeleton pose.
+	 */
+	Error accumulate_animation(const Ref<Animation> &p_animation, Skeleton3D *p_skeleton, double p_sample_rate = 30.0);
+
+	int64_t get_sample_count(int32_t p_bone) const;
+	int32_t get_open_cone_count(int32_t p_bone) const;
+	Vector3 get_open_cone_center(int32_t p_bone, int32_t p_index) const;
+	real_t get_open_cone_radius(int32_t p_bone, int32_t p_index) const;
+	/**
+	 * @return the fitted twist about the bone's Y axis in its parent's space, as (start, range) in radians.
+	 */
+	Vector2 get_twist(int32_t p_bone) const;
+
+	Ref<IKKusudama3D> create_kusudama(int32_t p_bone) const;
+	/**
+	 * Writes the fit of every bone with samples into the matching EWBIK3D constraint,
+	 * adding constraints for bones that do not have one yet. The twist is converted into
+	 * the frame the solver measures it in.
+	 */
+	void apply(EWBIK3D *p_many_bone_ik) const;
+};
@@ -329,7 +329,7 @@ Vector3 IKLimitCone3D::get_orthogonal(Vector3 p_in) {
 	return result;
 }
 
-Vector3 IKLimitCone3D::get_on_great_tangent_triangle(Ref<IKLimitCone3D> next, Vector3 input) const {
+Vector3 IKLimitCone3D::get_on_great_tangent_triangle(const Ref<IKLimitCone3D> &next, Vector3 input) const {
 	ERR_FAIL_COND_V(next.is_null(), input);
 
 	// Use interval arithmetic for robust cross products
@@ -110,7 +110,7 @@ public:
 	 * @return null if inapplicable for rectification. the original point if in bounds, or the point rectified to the closest boundary on the path sequence
 	 * between two cones if the point is out of bounds and applicable for rectification.
 	 */
-	Vector3 get_on_great_tangent_triangle(Ref<IKLimitCone3D> next, Vector3 input) const;
+	Vector3 get_on_great_tangent_triangle(const Ref<IKLimitCone3D> &next, Vector3 input) const;
 	double get_tangent_circle_radius_next();
 	Vector3 get_tangent_circle_center_next_1();
 	Vector3 get_tangent_circle_center_next_2();
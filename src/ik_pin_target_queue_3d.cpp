@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*  ik_pin_target_queue_3d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_pin_target_queue_3d.h"
+
+void IKPinTargetQueue3D::set_capacity(uint32_t p_capacity) {
+	uint32_t capacity = 2;
+	while (capacity < p_capacity) {
+		capacity <<= 1;
+	}
+	samples.resize(capacity);
+	mask = capacity - 1;
+	write_index.store(0, std::memory_order_relaxed);
+	read_index.store(0, std::memory_order_relaxed);
+}
+
+uint32_t IKPinTargetQueue3D::get_capacity() const {
+	return samples.size();
+}
+
+bool IKPinTargetQueue3D::push(const IKPinTargetSample3D &p_sample) {
+	const uint32_t write = write_index.load(std::memory_order_relaxed);
+	if (samples.is_empty() || write - read_index.load(std::memory_order_acquire) > mask) {
+		return false;
+	}
+	samples[write & mask] = p_sample;
+	// Publishes the slot; the consumer's acquire load of write_index sees the sample before the index.
+	write_index.store(write + 1, std::memory_order_release);
+	return true;
+}
+
+uint32_t IKPinTargetQueue3D::pop(IKPinTargetSample3D *r_samples, uint32_t p_max_count) {
+	const uint32_t read = read_index.load(std::memory_order_relaxed);
+	const uint32_t available = write_index.load(std::memory_order_acquire) - read;
+	const uint32_t count = MIN(available, p_max_count);
+	for (uint32_t sample_i = 0; sample_i < count; sample_i++) {
+		r_samples[sample_i] = samples[(read + sample_i) & mask];
+	}
+	// Hands the slots back to the producer only after they were copied out.
+	read_index.store(read + count, std::memory_order_release);
+	return count;
+}
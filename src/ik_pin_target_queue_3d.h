@@ -0,0 +1,63 @@
+/**************************************************************************/
+/*  ik_pin_target_queue_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/transform_3d.h"
+#include "core/templates/local_vector.h"
+
+#include <atomic>
+
+// A pin target pushed from another thread, consumed by EWBIK3D at the start of its next solve.
+struct IKPinTargetSample3D {
+	int32_t pin_index = -1;
+	double timestamp = 0.0; // Seconds on the OS::get_ticks_usec() clock.
+	Transform3D transform;
+	bool world_space = false;
+};
+
+// Wait-free single-producer, single-consumer ring of pin target samples.
+// One thread may push while one other thread pops; set_capacity() must not race with either.
+class IKPinTargetQueue3D {
+	LocalVector<IKPinTargetSample3D> samples;
+	uint32_t mask = 0;
+	// Both indices only grow, wrapping at 2^32; the slot is the index masked by the power of two capacity.
+	std::atomic<uint32_t> write_index{ 0 };
+	std::atomic<uint32_t> read_index{ 0 };
+
+public:
+	// Rounds up to a power of two and discards anything queued.
+	void set_capacity(uint32_t p_capacity);
+	uint32_t get_capacity() const;
+	// Producer side. Returns false, dropping the sample, when the consumer has fallen a full ring behind.
+	bool push(const IKPinTargetSample3D &p_sample);
+	// Consumer side. Copies out up to p_max_count of the oldest samples and returns how many.
+	uint32_t pop(IKPinTargetSample3D *r_samples, uint32_t p_max_count);
+};
@@ -0,0 +1,107 @@
+/**************************************************************************/
+/*  ik_pose_snapshot_3d.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_pose_snapshot_3d.h"
+
+void IKPoseSnapshot3D::resize(uint32_t p_bone_count) {
+	resizing.store(true);
+	while (reader_count.load() > 0) {
+		// A reader holds on for one copy of the pose at most.
+	}
+	for (Slot &slot : slots) {
+		slot.transforms.resize(p_bone_count * 2);
+		slot.sequence.store(0, std::memory_order_relaxed);
+	}
+	write_slot = 0;
+	latest_slot.store(NO_SLOT, std::memory_order_relaxed);
+	resizing.store(false);
+}
+
+uint32_t IKPoseSnapshot3D::get_bone_count() const {
+	return slots[0].transforms.size() / 2;
+}
+
+Transform3D *IKPoseSnapshot3D::begin_write() {
+	const uint32_t latest = latest_slot.load(std::memory_order_relaxed);
+	write_slot = latest == NO_SLOT ? 0 : (latest + 1) % SLOT_COUNT;
+	Slot &slot = slots[write_slot];
+	slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	// Readers that see the new data also see the odd sequence.
+	std::atomic_thread_fence(std::memory_order_release);
+	return slot.transforms.ptr();
+}
+
+void IKPoseSnapshot3D::end_write() {
+	Slot &slot = slots[write_slot];
+	slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	latest_slot.store(write_slot, std::memory_order_release);
+	version.fetch_add(1, std::memory_order_release);
+}
+
+bool IKPoseSnapshot3D::read(LocalVector<Transform3D> &r_transforms, uint64_t *r_version) const {
+	// Registering before checking for a resize pairs with the writer raising the flag before checking for readers.
+	reader_count.fetch_add(1);
+	if (resizing.load()) {
+		reader_count.fetch_sub(1);
+		return false;
+	}
+	bool read = false;
+	while (true) {
+		// The version is loaded before the slot, so it can only trail the pose that is copied.
+		const uint64_t read_version = version.load(std::memory_order_acquire);
+		const uint32_t latest = latest_slot.load(std::memory_order_acquire);
+		if (latest == NO_SLOT) {
+			break;
+		}
+		const Slot &slot = slots[latest];
+		const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence & 1) {
+			continue;
+		}
+		r_transforms.resize(slot.transforms.size());
+		for (uint32_t transform_i = 0; transform_i < slot.transforms.size(); transform_i++) {
+			r_transforms[transform_i] = slot.transforms[transform_i];
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+			if (r_version) {
+				*r_version = read_version;
+			}
+			read = true;
+			break;
+		}
+	}
+	reader_count.fetch_sub(1);
+	return read;
+}
+
+uint64_t IKPoseSnapshot3D::get_version() const {
+	return version.load(std::memory_order_acquire);
+}
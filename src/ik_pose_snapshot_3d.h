@@ -0,0 +1,70 @@
+/**************************************************************************/
+/*  ik_pose_snapshot_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/transform_3d.h"
+#include "core/templates/local_vector.h"
+
+#include <atomic>
+
+// The latest solved pose of a skeleton, readable from any thread without touching the scene tree.
+// Three seqlocked slots: one writer fills the slot after the published one, so a reader only retries
+// when the writer laps it twice during one copy. Each bone holds its bone-local pose, then its skeleton-space pose.
+class IKPoseSnapshot3D {
+public:
+	static constexpr uint32_t SLOT_COUNT = 3;
+	static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+private:
+	struct Slot {
+		std::atomic<uint32_t> sequence{ 0 }; // Odd while the writer is filling the slot.
+		LocalVector<Transform3D> transforms;
+	};
+	Slot slots[SLOT_COUNT];
+	uint32_t write_slot = 0;
+	std::atomic<uint32_t> latest_slot{ NO_SLOT };
+	std::atomic<uint64_t> version{ 0 };
+	// Resizing is the only time the writer waits: readers register so the slots are never freed under them.
+	mutable std::atomic<uint32_t> reader_count{ 0 };
+	std::atomic<bool> resizing{ false };
+
+public:
+	// Writer side. Drops the published pose; waits for readers still copying the old slots.
+	void resize(uint32_t p_bone_count);
+	uint32_t get_bone_count() const;
+	// Writer side. Returns the 2 * bone count transforms of the slot to fill, published by end_write().
+	Transform3D *begin_write();
+	void end_write();
+	// Any thread. Copies the latest pose into r_transforms; false before the first publish after a resize.
+	bool read(LocalVector<Transform3D> &r_transforms, uint64_t *r_version = nullptr) const;
+	// Counts publishes, so readers can tell whether the pose changed since their last read.
+	uint64_t get_version() const;
+};
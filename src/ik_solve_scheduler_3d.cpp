@@ -0,0 +1,156 @@
+/**************************************************************************/
+/*  ik_solve_scheduler_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_solve_scheduler_3d.h"
+
+#include "many_bone_ik_3d.h"
+
+void IKSolveScheduler3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_period", "period"), &IKSolveScheduler3D::set_period);
+	ClassDB::bind_method(D_METHOD("get_period"), &IKSolveScheduler3D::get_period);
+	ClassDB::bind_method(D_METHOD("has_instance", "instance"), &IKSolveScheduler3D::has_instance);
+	ClassDB::bind_method(D_METHOD("get_instance_count"), &IKSolveScheduler3D::get_instance_count);
+	ClassDB::bind_method(D_METHOD("set_instance_priority", "instance", "priority"), &IKSolveScheduler3D::set_instance_priority);
+	ClassDB::bind_method(D_METHOD("is_instance_priority", "instance"), &IKSolveScheduler3D::is_instance_priority);
+	ClassDB::bind_method(D_METHOD("get_instance_phase", "instance"), &IKSolveScheduler3D::get_instance_phase);
+	ClassDB::bind_method(D_METHOD("is_solve_frame", "instance", "frame"), &IKSolveScheduler3D::is_solve_frame);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "period", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), "set_period", "get_period");
+}
+
+uint32_t IKSolveScheduler3D::_acquire_phase() {
+	uint32_t phase = 0;
+	for (uint32_t phase_i = 1; phase_i < phase_loads.size(); phase_i++) {
+		if (phase_loads[phase_i] < phase_loads[phase]) {
+			phase = phase_i;
+		}
+	}
+	phase_loads[phase]++;
+	return phase;
+}
+
+void IKSolveScheduler3D::_rebalance() {
+	phase_loads.resize(period);
+	for (uint32_t &load : phase_loads) {
+		load = 0;
+	}
+	for (KeyValue<ObjectID, Instance> &E : instances) {
+		if (!E.value.priority) {
+			E.value.phase = _acquire_phase();
+		}
+	}
+}
+
+void IKSolveScheduler3D::set_period(int32_t p_period) {
+	ERR_FAIL_COND_MSG(p_period < 1, "Solve period must be at least one frame.");
+	period = p_period;
+	_rebalance();
+}
+
+int32_t IKSolveScheduler3D::get_period() const {
+	return period;
+}
+
+void IKSolveScheduler3D::add_instance(EWBIK3D *p_instance) {
+	ERR_FAIL_NULL(p_instance);
+	if (instances.has(p_instance->get_instance_id())) {
+		return;
+	}
+	Instance instance;
+	instance.phase = _acquire_phase();
+	instances.insert(p_instance->get_instance_id(), instance);
+}
+
+void IKSolveScheduler3D::remove_instance(EWBIK3D *p_instance) {
+	ERR_FAIL_NULL(p_instance);
+	HashMap<ObjectID, Instance>::Iterator E = instances.find(p_instance->get_instance_id());
+	if (!E) {
+		return;
+	}
+	if (!E->value.priority) {
+		phase_loads[E->value.phase]--;
+	}
+	instances.remove(E);
+}
+
+bool IKSolveScheduler3D::has_instance(EWBIK3D *p_instance) const {
+	return p_instance && instances.has(p_instance->get_instance_id());
+}
+
+int32_t IKSolveScheduler3D::get_instance_count() const {
+	return instances.size();
+}
+
+void IKSolveScheduler3D::set_instance_priority(EWBIK3D *p_instance, bool p_priority) {
+	ERR_FAIL_NULL(p_instance);
+	HashMap<ObjectID, Instance>::Iterator E = instances.find(p_instance->get_instance_id());
+	ERR_FAIL_COND_MSG(!E, "The instance is not scheduled by this scheduler.");
+	if (E->value.priority == p_priority) {
+		return;
+	}
+	// Priority instances solve every frame, so they give up their phase for the others to balance over.
+	E->value.priority = p_priority;
+	if (p_priority) {
+		phase_loads[E->value.phase]--;
+	} else {
+		E->value.phase = _acquire_phase();
+	}
+}
+
+bool IKSolveScheduler3D::is_instance_priority(EWBIK3D *p_instance) const {
+	ERR_FAIL_NULL_V(p_instance, false);
+	const Instance *instance = instances.getptr(p_instance->get_instance_id());
+	return instance && instance->priority;
+}
+
+int32_t IKSolveScheduler3D::get_instance_phase(EWBIK3D *p_instance) const {
+	ERR_FAIL_NULL_V(p_instance, -1);
+	const Instance *instance = instances.getptr(p_instance->get_instance_id());
+	if (!instance || instance->priority) {
+		return -1;
+	}
+	return instance->phase;
+}
+
+bool IKSolveScheduler3D::is_solve_frame(EWBIK3D *p_instance, uint64_t p_frame) const {
+	ERR_FAIL_NULL_V(p_instance, true);
+	const Instance *instance = instances.getptr(p_instance->get_instance_id());
+	if (!instance || instance->priority) {
+		return true;
+	}
+	return p_frame % uint64_t(period) == instance->phase;
+}
+
+IKSolveScheduler3D::IKSolveScheduler3D() {
+	phase_loads.resize(period);
+	for (uint32_t &load : phase_loads) {
+		load = 0;
+	}
+}
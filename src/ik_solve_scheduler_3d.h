@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*  ik_solve_scheduler_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/resource.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+class EWBIK3D;
+
+// Spreads the solves of many EWBIK3D instances round-robin across frames, so each solves once per period
+// in its own phase and the per-frame cost stays flat. Priority instances solve every frame.
+class IKSolveScheduler3D : public Resource {
+	GDCLASS(IKSolveScheduler3D, Resource);
+
+	struct Instance {
+		uint32_t phase = 0;
+		bool priority = false;
+	};
+	int32_t period = 3;
+	HashMap<ObjectID, Instance> instances;
+	LocalVector<uint32_t> phase_loads; // Non-priority instances per phase.
+
+	uint32_t _acquire_phase();
+	void _rebalance();
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_period(int32_t p_period);
+	int32_t get_period() const;
+	void add_instance(EWBIK3D *p_instance);
+	void remove_instance(EWBIK3D *p_instance);
+	bool has_instance(EWBIK3D *p_instance) const;
+	int32_t get_instance_count() const;
+	void set_instance_priority(EWBIK3D *p_instance, bool p_priority);
+	bool is_instance_priority(EWBIK3D *p_instance) const;
+	int32_t get_instance_phase(EWBIK3D *p_instance) const;
+	bool is_solve_frame(EWBIK3D *p_instance, uint64_t p_frame) const;
+
+	IKSolveScheduler3D();
+};
@@ -0,0 +1,290 @@
+/**************************************************************************/
+/*  ik_solver_backend_3d.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ik_solver_backend_3d.h"
+
+#include "ik_bone_3d.h"
+#include "ik_bone_segment_3d.h"
+#include "ik_effector_3d.h"
+#include "many_bone_ik_3d.h"
+
+IKSolverBackend3D *IKSolverBackend3D::create(int32_t p_backend) {
+	switch (p_backend) {
+		case EWBIK3D::SOLVER_BACKEND_FABRIK:
+			return memnew(IKFABRIKSolverBackend3D);
+		case EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES:
+			return memnew(IKDampedLeastSquaresSolverBackend3D);
+		default:
+			return memnew(IKQCPSolverBackend3D);
+	}
+}
+
+void IKQCPSolverBackend3D::solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	p_segment->_qcp_solver(p_damp, p_default_damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+}
+
+void IKFABRIKSolverBackend3D::solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	const Vector<Ref<IKEffector3D>> &effectors = p_segment->effector_list;
+	if (p_translate || p_constraint_mode || effectors.size() != 1 || effectors[0]->get_ik_bone_3d() != p_segment->tip) {
+		p_segment->_qcp_solver(p_damp, p_default_damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+		return;
+	}
+
+	// The bone list runs from the tip to the root, so joint 0 is the pinned bone.
+	const Vector<Ref<IKBone3D>> &bones = p_segment->bones;
+	const int32_t joint_count = bones.size();
+	joint_positions.resize(joint_count);
+	bone_lengths.resize(joint_count);
+	for (int32_t joint_i = 0; joint_i < joint_count; joint_i++) {
+		joint_positions[joint_i] = bones[joint_i]->get_bone_direction_global_pose().origin;
+	}
+	for (int32_t joint_i = 0; joint_i < joint_count - 1; joint_i++) {
+		bone_lengths[joint_i] = joint_positions[joint_i].distance_to(joint_positions[joint_i + 1]);
+	}
+	const Vector3 root_position = joint_positions[joint_count - 1];
+
+	// Backward pass: put the tip on the target and drag every joint after it.
+	joint_positions[0] = effectors[0]->get_target_global_transform().origin;
+	for (int32_t joint_i = 1; joint_i < joint_count; joint_i++) {
+		Vector3 direction = joint_positions[joint_i] - joint_positions[joint_i - 1];
+		if (direction.length_squared() > CMP_EPSILON2) {
+			joint_positions[joint_i] = joint_positions[joint_i - 1] + direction.normalized() * bone_lengths[joint_i - 1];
+		}
+	}
+	// Forward pass: put the root back and push every joint out again.
+	joint_positions[joint_count - 1] = root_position;
+	for (int32_t joint_i = joint_count - 1; joint_i-- > 0;) {
+		Vector3 direction = joint_positions[joint_i] - joint_positions[joint_i + 1];
+		if (direction.length_squared() > CMP_EPSILON2) {
+			joint_positions[joint_i] = joint_positions[joint_i + 1] + direction.normalized() * bone_lengths[joint_i];
+		}
+	}
+
+	// Turn the joint positions into rotations from the root down, so each bone sees its parent's new pose.
+	for (int32_t joint_i = joint_count - 1; joint_i > 0; joint_i--) {
+		const Ref<IKBone3D> &bone = bones[joint_i];
+		const Vector3 origin = bone->get_bone_direction_global_pose().origin;
+		const Vector3 current = bones[joint_i - 1]->get_bone_direction_global_pose().origin - origin;
+		const Vector3 desired = joint_positions[joint_i - 1] - origin;
+		if (current.length_squared() > CMP_EPSILON2 && desired.length_squared() > CMP_EPSILON2) {
+			bone->get_ik_transform()->rotate_local_with_global(Basis(Quaternion(current.normalized(), desired.normalized())));
+		}
+		p_segment->_snap_to_constraints(bone);
+	}
+
+	// Positions say nothing about the pinned bone's own orientation; fit it like the QCP backend does.
+	const Ref<IKBone3D> &tip_bone = bones[0];
+	if (!effectors[0]->is_following_translation_only()) {
+		p_segment->_update_optimal_rotation(tip_bone, p_segment->_get_bone_damp(tip_bone, p_damp, p_default_damp), false, false, p_current_iteration, p_total_iterations);
+	}
+}
+
+bool IKDampedLeastSquaresSolverBackend3D::_cholesky_solve(LocalVector<double> &r_matrix, LocalVector<double> &r_rhs, int32_t p_size) {
+	double *a = r_matrix.ptr();
+	double *b = r_rhs.ptr();
+	for (int32_t col_i = 0; col_i < p_size; col_i++) {
+		double diagonal = a[col_i * p_size + col_i];
+		for (int32_t k = 0; k < col_i; k++) {
+			diagonal -= a[col_i * p_size + k] * a[col_i * p_size + k];
+		}
+		if (diagonal <= 0.0) {
+			return false;
+		}
+		diagonal = Math::sqrt(diagonal);
+		a[col_i * p_size + col_i] = diagonal;
+		for (int32_t row_i = col_i + 1; row_i < p_size; row_i++) {
+			double value = a[row_i * p_size + col_i];
+			for (int32_t k = 0; k < col_i; k++) {
+				value -= a[row_i * p_size + k] * a[col_i * p_size + k];
+			}
+			a[row_i * p_size + col_i] = value / diagonal;
+		}
+	}
+	for (int32_t row_i = 0; row_i < p_size; row_i++) {
+		double value = b[row_i];
+		for (int32_t k = 0; k < row_i; k++) {
+			value -= a[row_i * p_size + k] * b[k];
+		}
+		b[row_i] = value / a[row_i * p_size + row_i];
+	}
+	for (int32_t row_i = p_size; row_i-- > 0;) {
+		double value = b[row_i];
+		for (int32_t k = row_i + 1; k < p_size; k++) {
+			value -= a[k * p_size + row_i] * b[k];
+		}
+		b[row_i] = value / a[row_i * p_size + row_i];
+	}
+	return true;
+}
+
+void IKDampedLeastSquaresSolverBackend3D::solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) {
+	if (p_translate || p_constraint_mode || p_segment->effector_list.is_empty()) {
+		p_segment->_qcp_solver(p_damp, p_default_damp, p_translate, p_constraint_mode, p_current_iteration, p_total_iterations);
+		return;
+	}
+
+	const Vector<Ref<IKBone3D>> &bones = p_segment->bones;
+	const Vector<double> &weights = p_segment->heading_weights;
+	const int32_t bone_count = bones.size();
+	const int32_t heading_count = weights.size();
+	const int32_t row_count = heading_count * 3;
+	const int32_t column_count = bone_count * 3;
+	bone_origins.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		bone_origins[bone_i] = bones[bone_i]->get_bone_direction_global_pose().origin;
+	}
+	jacobian.resize(row_count * column_count);
+	error.resize(row_count);
+
+	// Rows are the segment's own headings, fitted for its root bone the way the QCP backend fits each bone,
+	// so both backends see the same weights and the same axis scaling toward a nearby target. Turning any
+	// bone about its joint moves a tip heading by its scale times axis x (heading point - joint).
+	const Vector3 root_origin = bone_origins[bone_count - 1];
+	p_segment->_update_target_headings(bones[bone_count - 1], &p_segment->heading_weights, &p_segment->target_headings);
+	p_segment->_update_tip_headings(bones[bone_count - 1], &p_segment->tip_headings);
+	const Vector3 *tip_headings = p_segment->tip_headings.ptr();
+	const Vector3 *target_headings = p_segment->target_headings.ptr();
+	int32_t heading_i = 0;
+	for (const Ref<IKEffector3D> &effector : p_segment->effector_list) {
+		if (effector.is_null()) {
+			continue;
+		}
+		const Vector3 priorities = effector->get_direction_priorities();
+		const real_t axis_scale = effector->get_tip_heading_scale(root_origin);
+		// The effector writes its origin, then both ends of every prioritized axis.
+		for (int32_t point_i = -1; point_i < 6 && heading_i < heading_count; point_i++) {
+			real_t scale = 1.0;
+			if (point_i >= 0) {
+				if (priorities[point_i / 2] <= 0.0) {
+					continue;
+				}
+				scale = axis_scale;
+			}
+			const double weight = Math::sqrt(MAX(weights[heading_i], 0.0));
+			const Vector3 delta = target_headings[heading_i] - tip_headings[heading_i];
+			double *row_x = &jacobian[heading_i * 3 * column_count];
+			double *row_y = row_x + column_count;
+			double *row_z = row_y + column_count;
+			error[heading_i * 3 + 0] = delta.x * weight;
+			error[heading_i * 3 + 1] = delta.y * weight;
+			error[heading_i * 3 + 2] = delta.z * weight;
+			for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+				// Column k of a bone is the motion of the heading under a rotation about global axis k: axis x arm.
+				const Vector3 arm = tip_headings[heading_i] + (root_origin - bone_origins[bone_i]) * scale;
+				const int32_t col_i = bone_i * 3;
+				row_x[col_i + 0] = 0.0;
+				row_y[col_i + 0] = -arm.z * weight;
+				row_z[col_i + 0] = arm.y * weight;
+				row_x[col_i + 1] = arm.z * weight;
+				row_y[col_i + 1] = 0.0;
+				row_z[col_i + 1] = -arm.x * weight;
+				row_x[col_i + 2] = -arm.y * weight;
+				row_y[col_i + 2] = arm.x * weight;
+				row_z[col_i + 2] = 0.0;
+			}
+			heading_i++;
+		}
+	}
+	const int32_t used_rows = heading_i * 3;
+	if (used_rows == 0) {
+		return;
+	}
+
+	// Solve whichever of the two equivalent damped normal equations is smaller.
+	const double damping_squared = DAMPING * DAMPING;
+	step.resize(column_count);
+	if (used_rows <= column_count) {
+		// (J J^T + lambda^2 I) y = e, step = J^T y
+		system.resize(used_rows * used_rows);
+		rhs.resize(used_rows);
+		for (int32_t a_i = 0; a_i < used_rows; a_i++) {
+			const double *row_a = &jacobian[a_i * column_count];
+			for (int32_t b_i = 0; b_i <= a_i; b_i++) {
+				const double *row_b = &jacobian[b_i * column_count];
+				double sum = 0.0;
+				for (int32_t col_i = 0; col_i < column_count; col_i++) {
+					sum += row_a[col_i] * row_b[col_i];
+				}
+				system[a_i * used_rows + b_i] = sum;
+				system[b_i * used_rows + a_i] = sum;
+			}
+			system[a_i * used_rows + a_i] += damping_squared;
+			rhs[a_i] = error[a_i];
+		}
+		if (!_cholesky_solve(system, rhs, used_rows)) {
+			return;
+		}
+		for (int32_t col_i = 0; col_i < column_count; col_i++) {
+			double sum = 0.0;
+			for (int32_t row_i = 0; row_i < used_rows; row_i++) {
+				sum += jacobian[row_i * column_count + col_i] * rhs[row_i];
+			}
+			step[col_i] = sum;
+		}
+	} else {
+		// (J^T J + lambda^2 I) step = J^T e
+		system.resize(column_count * column_count);
+		rhs.resize(column_count);
+		for (int32_t a_i = 0; a_i < column_count; a_i++) {
+			for (int32_t b_i = 0; b_i <= a_i; b_i++) {
+				double sum = 0.0;
+				for (int32_t row_i = 0; row_i < used_rows; row_i++) {
+					sum += jacobian[row_i * column_count + a_i] * jacobian[row_i * column_count + b_i];
+				}
+				system[a_i * column_count + b_i] = sum;
+				system[b_i * column_count + a_i] = sum;
+			}
+			system[a_i * column_count + a_i] += damping_squared;
+			double projected = 0.0;
+			for (int32_t row_i = 0; row_i < used_rows; row_i++) {
+				projected += jacobian[row_i * column_count + a_i] * error[row_i];
+			}
+			rhs[a_i] = projected;
+		}
+		if (!_cholesky_solve(system, rhs, column_count)) {
+			return;
+		}
+		for (int32_t col_i = 0; col_i < column_count; col_i++) {
+			step[col_i] = rhs[col_i];
+		}
+	}
+
+	// The Jacobian treats all bones as turning at once; tip first keeps each rotation about its own joint.
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bones[bone_i];
+		const Vector3 rotation_vector = Vector3(step[bone_i * 3 + 0], step[bone_i * 3 + 1], step[bone_i * 3 + 2]);
+		const real_t angle = rotation_vector.length();
+		if (angle > CMP_EPSILON) {
+			const real_t max_angle = p_segment->_get_bone_damp(bone, p_damp, p_default_damp);
+			bone->get_ik_transform()->rotate_local_with_global(Basis(rotation_vector / angle, MIN(angle, max_angle)));
+		}
+		p_segment->_snap_to_constraints(bone);
+	}
+}
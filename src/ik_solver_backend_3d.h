@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  ik_solver_backend_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/vector.h"
+
+class IKBoneSegment3D;
+
+/**
+ * One strategy for moving the bones of a segment toward the segment's effector headings.
+ * Every backend reads the same headings and applies the same kusudama constraints; they only
+ * differ in how the bone rotations for an iteration are found.
+ */
+class IKSolverBackend3D {
+public:
+	virtual ~IKSolverBackend3D() {}
+	virtual void solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) = 0;
+
+	/**
+	 * @param p_backend an EWBIK3D::SolverBackend value.
+	 * @return a new backend owned by the caller, released with memdelete().
+	 */
+	static IKSolverBackend3D *create(int32_t p_backend);
+};
+
+/**
+ * The cyclic coordinate descent over bones that fits each bone with QCP, tip first.
+ */
+class IKQCPSolverBackend3D : public IKSolverBackend3D {
+public:
+	virtual void solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) override;
+};
+
+/**
+ * Forward and backward reaching over the joint positions of a single-effector chain.
+ * Segments that translate, carry more than one effector or run in constraint mode use QCP instead.
+ */
+class IKFABRIKSolverBackend3D : public IKSolverBackend3D {
+	LocalVector<Vector3> joint_positions;
+	LocalVector<real_t> bone_lengths;
+
+public:
+	virtual void solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) override;
+};
+
+/**
+ * Damped least squares on the Jacobian of every heading with respect to three rotational degrees
+ * of freedom per bone. Each bone's step is limited by its dampening like the QCP steps are.
+ * Segments that translate or run in constraint mode use QCP instead.
+ */
+class IKDampedLeastSquaresSolverBackend3D : public IKSolverBackend3D {
+	static constexpr double DAMPING = 0.1;
+
+	LocalVector<Vector3> bone_origins;
+	LocalVector<double> jacobian;
+	LocalVector<double> error;
+	LocalVector<double> system;
+	LocalVector<double> rhs;
+	LocalVector<double> step;
+
+	static bool _cholesky_solve(LocalVector<double> &r_matrix, LocalVector<double> &r_rhs, int32_t p_size);
+
+public:
+	virtual void solve(IKBoneSegment3D *p_segment, const Vector<float> &p_damp, float p_default_damp, bool p_translate, bool p_constraint_mode, int32_t p_current_iteration, int32_t p_total_iterations) override;
+};
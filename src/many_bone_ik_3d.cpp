@@ -29,18 +29,24 @@
 /**************************************************************************/
 
 #include "many_bone_ik_3d.h"
+#include "core/config/engine.h"
 #include "core/error/error_macros.h"
 #include "core/math/math_defs.h"
 #include "core/object/class_db.h"
 #include "core/object/object.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/string/string_name.h"
 #include "ik_bone_3d.h"
+#include "ik_effector_3d.h"
 #include "ik_kusudama_3d.h"
 #include "ik_open_cone_3d.h"
+#include "scene/3d/camera_3d.h"
 #include "scene/3d/marker_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
 
 void EWBIK3D::set_pin_count(int32_t p_value) {
 	int32_t old_count = pins.size();
@@ -97,6 +103,177 @@ NodePath EWBIK3D::get_pin_target_node_path(int32_t p_pin_index) {
 	return effector_template->get_target_node();
 }
 
+void EWBIK3D::_set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform, bool p_world) {
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_null()) {
+		effector_template.instantiate();
+		pins.write[p_pin_index] = effector_template;
+	}
+	// The template keeps the target across segment rebuilds; the live effector picks it up without one.
+	// World targets stay in world space and are converted again each time the skeleton moves.
+	effector_template->set_target_transform(p_transform, p_world);
+	// While an async solve runs, the effector picks the template up when the next one launches.
+	if (async_solve_task == WorkerThreadPool::INVALID_TASK_ID && p_pin_index < pin_effectors.size() && pin_effectors[p_pin_index].is_valid()) {
+		const Ref<IKEffector3D> &effector = pin_effectors[p_pin_index];
+		// Re-pushing the target it already has, as an interpolated pin does once it reaches its newest sample, is not a move.
+		if (!effector->is_using_target_transform() || effector->is_target_transform_world() != p_world || effector->get_target_transform() != p_transform) {
+			effector->set_target_transform(p_transform, p_world, p_world ? get_skeleton()->get_global_transform().affine_inverse() : Transform3D());
+			_mark_pin_moved(p_pin_index);
+		}
+	}
+}
+
+void EWBIK3D::set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform, PinTargetSpace p_space) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	ERR_FAIL_COND_MSG(p_space == PIN_TARGET_SPACE_WORLD && !get_skeleton(), "World space pin targets need a skeleton to convert from.");
+	_set_pin_target_transform(p_pin_index, p_transform, p_space == PIN_TARGET_SPACE_WORLD);
+}
+
+void EWBIK3D::set_pin_target_transforms(const PackedFloat32Array &p_transforms, PinTargetSpace p_space) {
+	// Twelve floats per pin, laid out like MultiMesh's buffer: each basis row followed by that row's origin component.
+	ERR_FAIL_COND_MSG(p_transforms.size() % 12 != 0, "Pin target transforms must hold twelve floats per pin.");
+	const int32_t transform_count = p_transforms.size() / 12;
+	ERR_FAIL_COND_MSG(transform_count > pins.size(), "More pin target transforms than pins.");
+	ERR_FAIL_COND_MSG(p_space == PIN_TARGET_SPACE_WORLD && !get_skeleton(), "World space pin targets need a skeleton to convert from.");
+	const float *data = p_transforms.ptr();
+	for (int32_t pin_i = 0; pin_i < transform_count; pin_i++) {
+		const float *xform = data + pin_i * 12;
+		const Transform3D transform(xform[0], xform[1], xform[2], xform[4], xform[5], xform[6], xform[8], xform[9], xform[10], xform[3], xform[7], xform[11]);
+		_set_pin_target_transform(pin_i, transform, p_space == PIN_TARGET_SPACE_WORLD);
+	}
+}
+
+Transform3D EWBIK3D::get_pin_target_transform(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), Transform3D());
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), Transform3D());
+	if (effector_template->is_target_transform_world()) {
+		Skeleton3D *skeleton = get_skeleton();
+		ERR_FAIL_NULL_V(skeleton, Transform3D());
+		return skeleton->get_global_transform().affine_inverse() * effector_template->get_target_transform();
+	}
+	return effector_template->get_target_transform();
+}
+
+void EWBIK3D::clear_pin_target_transform(int32_t p_pin_index) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	if (uint32_t(p_pin_index) < pin_target_history_count.size()) {
+		pin_target_history_count[p_pin_index] = 0;
+		pin_target_received[p_pin_index] = false;
+	}
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	if (effector_template.is_valid()) {
+		effector_template->clear_target_transform();
+	}
+	if (async_solve_task == WorkerThreadPool::INVALID_TASK_ID && p_pin_index < pin_effectors.size() && pin_effectors[p_pin_index].is_valid()) {
+		pin_effectors[p_pin_index]->clear_target_transform();
+		_mark_pin_moved(p_pin_index);
+	}
+}
+
+bool EWBIK3D::is_pin_target_transform_enabled(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), false);
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	return effector_template.is_valid() && effector_template->is_target_transform_enabled();
+}
+
+bool EWBIK3D::push_pin_target(int32_t p_pin_index, const Transform3D &p_transform, double p_timestamp, PinTargetSpace p_space) {
+	// Runs on the producer's thread, so the pin index is only checked against the pins when the queue is drained.
+	ERR_FAIL_COND_V(p_pin_index < 0, false);
+	IKPinTargetSample3D sample;
+	sample.pin_index = p_pin_index;
+	sample.timestamp = p_timestamp;
+	sample.transform = p_transform;
+	sample.world_space = p_space == PIN_TARGET_SPACE_WORLD;
+	return pin_target_queue.push(sample);
+}
+
+void EWBIK3D::set_pin_target_queue_capacity(int32_t p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "The pin target queue needs room for at least one sample.");
+	pin_target_queue.set_capacity(p_capacity);
+	pin_target_drain.resize(pin_target_queue.get_capacity());
+}
+
+int32_t EWBIK3D::get_pin_target_queue_capacity() const {
+	return pin_target_queue.get_capacity();
+}
+
+void EWBIK3D::set_pin_target_interpolation_delay(float p_delay) {
+	ERR_FAIL_COND_MSG(p_delay < 0.0f, "Pin target interpolation delay must not be negative.");
+	pin_target_interpolation_delay = p_delay;
+}
+
+float EWBIK3D::get_pin_target_interpolation_delay() const {
+	return pin_target_interpolation_delay;
+}
+
+void EWBIK3D::_drain_pin_target_queue() {
+	const uint32_t pin_total = pins.size();
+	if (pin_target_history_count.size() != pin_total) {
+		pin_target_history.resize(pin_total * PIN_TARGET_HISTORY_SIZE);
+		pin_target_history_count.resize(pin_total);
+		pin_target_received.resize(pin_total);
+		for (uint32_t pin_i = 0; pin_i < pin_total; pin_i++) {
+			pin_target_history_count[pin_i] = 0;
+			pin_target_received[pin_i] = false;
+		}
+	}
+
+	uint32_t count = 0;
+	while ((count = pin_target_queue.pop(pin_target_drain.ptr(), pin_target_drain.size())) > 0) {
+		for (uint32_t sample_i = 0; sample_i < count; sample_i++) {
+			const IKPinTargetSample3D &sample = pin_target_drain[sample_i];
+			if (uint32_t(sample.pin_index) >= pin_total) {
+				continue;
+			}
+			IKPinTargetSample3D *history = pin_target_history.ptr() + sample.pin_index * PIN_TARGET_HISTORY_SIZE;
+			uint8_t &history_count = pin_target_history_count[sample.pin_index];
+			if (history_count == PIN_TARGET_HISTORY_SIZE) {
+				for (int32_t history_i = 1; history_i < PIN_TARGET_HISTORY_SIZE; history_i++) {
+					history[history_i - 1] = history[history_i];
+				}
+				history_count--;
+			}
+			history[history_count++] = sample;
+			pin_target_received[sample.pin_index] = true;
+		}
+	}
+
+	// Without a delay only the newest sample matters; with one, every queued pin moves along its history each frame.
+	const bool interpolate = pin_target_interpolation_delay > 0.0f;
+	const double sample_time = double(OS::get_singleton()->get_ticks_usec()) / 1000000.0 - pin_target_interpolation_delay;
+	for (uint32_t pin_i = 0; pin_i < pin_total; pin_i++) {
+		const uint8_t history_count = pin_target_history_count[pin_i];
+		if (history_count == 0 || (!interpolate && !pin_target_received[pin_i])) {
+			continue;
+		}
+		pin_target_received[pin_i] = false;
+		const IKPinTargetSample3D *history = pin_target_history.ptr() + pin_i * PIN_TARGET_HISTORY_SIZE;
+		if (!interpolate || sample_time >= history[history_count - 1].timestamp) {
+			_set_pin_target_transform(pin_i, history[history_count - 1].transform, history[history_count - 1].world_space);
+			continue;
+		}
+		int32_t next_i = 0;
+		while (next_i < history_count - 1 && history[next_i].timestamp <= sample_time) {
+			next_i++;
+		}
+		if (next_i == 0) {
+			_set_pin_target_transform(pin_i, history[0].transform, history[0].world_space);
+			continue;
+		}
+		const IKPinTargetSample3D &previous = history[next_i - 1];
+		const IKPinTargetSample3D &next = history[next_i];
+		if (previous.world_space != next.world_space) {
+			// Samples in different spaces are not blended; the pin snaps to the newer one.
+			_set_pin_target_transform(pin_i, next.transform, next.world_space);
+			continue;
+		}
+		const double span = next.timestamp - previous.timestamp;
+		const real_t weight = span > 0.0 ? real_t((sample_time - previous.timestamp) / span) : real_t(1.0);
+		_set_pin_target_transform(pin_i, previous.transform.interpolate_with(next.transform, weight), next.world_space);
+	}
+}
+
 Vector<Ref<IKEffectorTemplate3D>> EWBIK3D::_get_bone_effectors() const {
 	return pins;
 }
@@ -110,32 +287,238 @@ void EWBIK3D::_remove_pin(int32_t p_index) {
 }
 
 void EWBIK3D::_update_ik_bones_transform() {
-	for (int32_t bone_i = bone_list.size(); bone_i-- > 0;) {
-		Ref<IKBone3D> bone = bone_list[bone_i];
+	if (async_solve_task != WorkerThreadPool::INVALID_TASK_ID) {
+		// The worker owns the IK nodes; the next launch reads the skeleton instead.
+		return;
+	}
+	Skeleton3D *skeleton = get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	// Read every local pose into the flat buffer first, then write the IK nodes without propagating.
+	// One propagation from the shared origin afterwards dirties each node once, instead of once per ancestor that moved.
+	const int32_t bone_count = bone_list.size();
+	bone_poses.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		if (bone.is_valid() && bone->get_bone_id() != -1) {
+			bone_poses[bone_i] = skeleton->get_bone_pose(bone->get_bone_id());
+		}
+	}
+	for (uint32_t unscoped_i = 0; unscoped_i < unscoped_bones.size(); unscoped_i++) {
+		unscoped_bone_poses[unscoped_i] = skeleton->get_bone_pose(unscoped_bones[unscoped_i]);
+	}
+	const bool propagate_per_bone = ik_origin.is_null();
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
 		if (bone.is_null()) {
 			continue;
 		}
-		bone->set_initial_pose(get_skeleton());
-		if (bone->is_pinned()) {
-			bone->get_pin()->update_target_global_transform(get_skeleton(), this);
+		if (bone->get_bone_id() != -1) {
+			bone->get_ik_transform()->set_transform(bone_poses[bone_i], propagate_per_bone);
+		}
+	}
+	for (int32_t segment_i = 0; segment_i < segment_root_parents.size(); segment_i++) {
+		const Ref<IKNode3D> &root_parent = segment_root_parents[segment_i];
+		if (root_parent.is_valid()) {
+			const BoneId parent = skeleton->get_bone_parent(segmented_skeletons[segment_i]->get_root()->get_bone_id());
+			root_parent->set_transform(skeleton->get_bone_global_pose(parent), propagate_per_bone);
+		}
+	}
+	if (!propagate_per_bone) {
+		ik_origin->_propagate_transform_changed();
+	}
+	// Node targets are re-read only when the node or the skeleton moved; the pins that changed are queued for the next solve.
+	const Transform3D skeleton_transform = skeleton->get_global_transform();
+	const bool skeleton_moved = skeleton_transform != target_skeleton_transform;
+	target_skeleton_transform = skeleton_transform;
+	const Transform3D to_skeleton = skeleton_transform.affine_inverse();
+	for (int32_t pin_i = 0; pin_i < pin_effectors.size(); pin_i++) {
+		const Ref<IKEffector3D> &effector = pin_effectors[pin_i];
+		if (effector.is_valid() && effector->update_target_global_transform(to_skeleton, skeleton_moved, this)) {
+			_mark_pin_moved(pin_i);
 		}
 	}
 }
 
 void EWBIK3D::_update_skeleton_bones_transform() {
-	for (int32_t bone_i = bone_list.size(); bone_i-- > 0;) {
-		Ref<IKBone3D> bone = bone_list[bone_i];
-		if (bone.is_null()) {
+	// Collect the solved poses, then hand each bone to the skeleton with a single setter call.
+	_gather_bone_poses(bone_poses);
+	_publish_bone_poses(bone_poses);
+	_write_bone_poses(bone_poses);
+}
+
+void EWBIK3D::_gather_bone_poses(LocalVector<Transform3D> &r_poses) const {
+	const int32_t bone_count = bone_list.size();
+	r_poses.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		if (bone.is_null() || bone->get_bone_id() == -1) {
+			continue;
+		}
+		Transform3D pose = bone->get_pose();
+		if (!pose.basis.is_finite()) {
+			pose.basis = Basis();
+		}
+		r_poses[bone_i] = pose;
+	}
+}
+
+void EWBIK3D::_publish_bone_poses(const LocalVector<Transform3D> &p_poses) {
+	const int32_t snapshot_bone_count = pose_snapshot.get_bone_count();
+	Transform3D *transforms = pose_snapshot.begin_write();
+	for (int32_t bone_i = 0; bone_i < bone_list.size() && bone_i < int32_t(p_poses.size()); bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		if (bone.is_null() || bone->get_bone_id() < 0 || bone->get_bone_id() >= snapshot_bone_count) {
+			continue;
+		}
+		const int32_t bone_id = bone->get_bone_id();
+		transforms[bone_id * 2] = p_poses[bone_i];
+		transforms[bone_id * 2 + 1] = bone->get_global_pose();
+	}
+	// Bones outside the scope keep their incoming pose and ride along with their parent, which was written first.
+	for (uint32_t unscoped_i = 0; unscoped_i < unscoped_bones.size(); unscoped_i++) {
+		const BoneId bone_id = unscoped_bones[unscoped_i];
+		const BoneId parent = unscoped_bone_parents[unscoped_i];
+		if (bone_id >= snapshot_bone_count || parent >= snapshot_bone_count) {
+			continue;
+		}
+		const Transform3D &pose = unscoped_bone_poses[unscoped_i];
+		transforms[bone_id * 2] = pose;
+		transforms[bone_id * 2 + 1] = parent == -1 ? pose : transforms[parent * 2 + 1] * pose;
+	}
+	pose_snapshot.end_write();
+}
+
+void EWBIK3D::_update_bone_pose_write_thresholds() {
+	const int32_t bone_count = bone_list.size();
+	bone_pose_write_thresholds.resize(bone_count);
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		float translation_epsilon = pose_write_translation_epsilon;
+		float rotation_epsilon = pose_write_rotation_epsilon;
+		if (bone.is_valid() && bone->get_bone_id() != -1) {
+			const StringName bone_name = get_skeleton()->get_bone_name(bone->get_bone_id());
+			for (int32_t override_i = 0; override_i < pose_write_bone_count; override_i++) {
+				if (pose_write_bone_names[override_i] != bone_name) {
+					continue;
+				}
+				const Vector2 epsilons = pose_write_bone_epsilons[override_i];
+				translation_epsilon = epsilons.x < 0.0f ? translation_epsilon : epsilons.x;
+				rotation_epsilon = epsilons.y < 0.0f ? rotation_epsilon : epsilons.y;
+				break;
+			}
+		}
+		if (translation_epsilon <= 0.0f && rotation_epsilon <= 0.0f) {
+			bone_pose_write_thresholds[bone_i] = Vector2(-1.0f, 1.0f);
 			continue;
 		}
-		if (bone->get_bone_id() == -1) {
+		bone_pose_write_thresholds[bone_i] = Vector2(translation_epsilon * translation_epsilon, Math::cos(MIN(rotation_epsilon, float(Math::PI)) * 0.5f));
+	}
+	bone_pose_write_thresholds_dirty = false;
+}
+
+void EWBIK3D::_write_bone_poses(const LocalVector<Transform3D> &p_poses) {
+	Skeleton3D *skeleton = get_skeleton();
+	ERR_FAIL_NULL(skeleton);
+	// Every write dirties the bone's subtree in the skeleton, and with it skinning and attachments,
+	// so bones that stayed within their epsilons of the skeleton's pose keep it.
+	const bool write_all = pose_write_translation_epsilon <= 0.0f && pose_write_rotation_epsilon <= 0.0f && pose_write_bone_count == 0;
+	if (!write_all && (bone_pose_write_thresholds_dirty || bone_pose_write_thresholds.size() != uint32_t(bone_list.size()))) {
+		_update_bone_pose_write_thresholds();
+	}
+	const int32_t bone_count = MIN(int32_t(p_poses.size()), bone_list.size());
+	last_written_bone_count = 0;
+	for (int32_t bone_i = 0; bone_i < bone_count; bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		if (bone.is_null() || bone->get_bone_id() == -1) {
 			continue;
 		}
-		bone->set_skeleton_bone_pose(get_skeleton());
+		const BoneId bone_id = bone->get_bone_id();
+		const Transform3D &pose = p_poses[bone_i];
+		if (!write_all && bone_pose_write_thresholds[bone_i].x >= 0.0f) {
+			// The solver never scales bones, so any scale change is written.
+			const Vector2 &threshold = bone_pose_write_thresholds[bone_i];
+			const bool moved = pose.origin.distance_squared_to(skeleton->get_bone_pose_position(bone_id)) > threshold.x ||
+					Math::abs(pose.basis.get_rotation_quaternion().dot(skeleton->get_bone_pose_rotation(bone_id))) < threshold.y ||
+					!pose.basis.get_scale().is_equal_approx(skeleton->get_bone_pose_scale(bone_id));
+			if (!moved) {
+				continue;
+			}
+		}
+		skeleton->set_bone_pose(bone_id, pose);
+		last_written_bone_count++;
 	}
 	update_gizmos();
 }
 
+void EWBIK3D::_solve(int32_t p_iterations) {
+	for (int32_t i = 0; i < p_iterations; i++) {
+		if (async_solve_cancelled.is_set()) {
+			return;
+		}
+		for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+			if (segmented_skeleton.is_null()) {
+				continue;
+			}
+			segmented_skeleton->segment_solver(bone_damp, get_default_damp(), get_constraint_mode(), i, p_iterations);
+		}
+	}
+}
+
+void EWBIK3D::_solve_async(int32_t p_iterations) {
+	// Runs on a worker. The main thread leaves the IK nodes and the back buffer alone until the task is waited on.
+	_solve(p_iterations);
+	if (!async_solve_cancelled.is_set()) {
+		_gather_bone_poses(async_poses[1 - async_front_poses]);
+		_publish_bone_poses(async_poses[1 - async_front_poses]);
+	}
+}
+
+void EWBIK3D::_launch_async_solve() {
+	// Gather the inputs on the main thread: the latest pose, the node targets and the pushed target transforms.
+	if (lod_apply_pending) {
+		_apply_lod_to_segments();
+	}
+	_update_ik_bones_transform();
+	for (int32_t pin_i = 0; pin_i < pin_effectors.size() && pin_i < pins.size(); pin_i++) {
+		const Ref<IKEffector3D> &effector = pin_effectors[pin_i];
+		const Ref<IKEffectorTemplate3D> &effector_template = pins[pin_i];
+		if (effector.is_null() || effector_template.is_null()) {
+			continue;
+		}
+		if (effector_template->is_target_transform_enabled()) {
+			const Transform3D target = effector_template->get_target_transform();
+			const bool world = effector_template->is_target_transform_world();
+			if (!effector->is_using_target_transform() || effector->is_target_transform_world() != world || effector->get_target_transform() != target) {
+				effector->set_target_transform(target, world, target_skeleton_transform.affine_inverse());
+				_mark_pin_moved(pin_i);
+			}
+		} else if (effector->is_using_target_transform()) {
+			effector->clear_target_transform();
+			_mark_pin_moved(pin_i);
+		}
+	}
+	_prepare_segment_solve();
+	async_solve_cancelled.clear();
+	async_solve_task = WorkerThreadPool::get_singleton()->add_template_task(this, &EWBIK3D::_solve_async, _get_solve_iterations(), false, SNAME("EWBIK3D::solve_async"));
+}
+
+void EWBIK3D::_finish_async_solve(bool p_cancel) {
+	if (async_solve_task == WorkerThreadPool::INVALID_TASK_ID) {
+		return;
+	}
+	if (p_cancel) {
+		async_solve_cancelled.set();
+	}
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(async_solve_task);
+	async_solve_task = WorkerThreadPool::INVALID_TASK_ID;
+	if (async_solve_cancelled.is_set()) {
+		// A cancelled solve stopped part way, so its back buffer is never shown.
+		async_solve_cancelled.clear();
+		return;
+	}
+	async_front_poses = 1 - async_front_poses;
+}
+
 void EWBIK3D::_get_property_list(List<PropertyInfo> *p_list) const {
 	const Vector<Ref<IKBone3D>> ik_bones = get_bone_list();
 	RBSet<StringName> existing_pins;
@@ -180,6 +563,8 @@ void EWBIK3D::_get_property_list(List<PropertyInfo> *p_list) const {
 				PropertyInfo(Variant::FLOAT, "pins/" + itos(pin_i) + "/weight", PROPERTY_HINT_RANGE, "0,1,0.1,or_greater", pin_usage));
 		p_list->push_back(
 				PropertyInfo(Variant::VECTOR3, "pins/" + itos(pin_i) + "/direction_priorities", PROPERTY_HINT_RANGE, "0,1,0.1,or_greater", pin_usage));
+		p_list->push_back(
+				PropertyInfo(Variant::STRING_NAME, "pins/" + itos(pin_i) + "/root_bone", PROPERTY_HINT_NONE, "", pin_usage));
 	}
 	uint32_t constraint_usage = PROPERTY_USAGE_DEFAULT;
 	p_list->push_back(
@@ -231,6 +616,30 @@ void EWBIK3D::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(
 				PropertyInfo(Variant::TRANSFORM3D, "constraints/" + itos(constraint_i) + "/bone_direction", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE));
 	}
+	p_list->push_back(
+			PropertyInfo(Variant::INT, "pose_write_bone_count",
+					PROPERTY_HINT_RANGE, "0,65536,or_greater", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_ARRAY,
+					"Pose Write Overrides,bones/"));
+	for (int32_t override_i = 0; override_i < pose_write_bone_count; override_i++) {
+		PropertyInfo bone_name;
+		bone_name.type = Variant::STRING_NAME;
+		bone_name.usage = PROPERTY_USAGE_DEFAULT;
+		bone_name.name = "bones/" + itos(override_i) + "/bone_name";
+		if (get_skeleton()) {
+			String names;
+			for (int bone_i = 0; bone_i < get_skeleton()->get_bone_count(); bone_i++) {
+				names += get_skeleton()->get_bone_name(bone_i) + ",";
+			}
+			bone_name.hint = PROPERTY_HINT_ENUM_SUGGESTION;
+			bone_name.hint_string = names;
+		}
+		p_list->push_back(bone_name);
+		// A negative epsilon falls back to the modifier's own.
+		p_list->push_back(
+				PropertyInfo(Variant::FLOAT, "bones/" + itos(override_i) + "/pose_write_translation_epsilon", PROPERTY_HINT_RANGE, "-1,0.1,0.0001,or_greater,suffix:m"));
+		p_list->push_back(
+				PropertyInfo(Variant::FLOAT, "bones/" + itos(override_i) + "/pose_write_rotation_epsilon", PROPERTY_HINT_RANGE, "-1,10,0.01,radians"));
+	}
 }
 
 bool EWBIK3D::_get(const StringName &p_name, Variant &r_ret) const {
@@ -244,6 +653,23 @@ bool EWBIK3D::_get(const StringName &p_name, Variant &r_ret) const {
 	} else if (name == "bone_count") {
 		r_ret = get_bone_count();
 		return true;
+	} else if (name == "pose_write_bone_count") {
+		r_ret = get_pose_write_bone_count();
+		return true;
+	} else if (name.begins_with("bones/")) {
+		int index = name.get_slicec('/', 1).to_int();
+		String what = name.get_slicec('/', 2);
+		ERR_FAIL_INDEX_V(index, pose_write_bone_count, false);
+		if (what == "bone_name") {
+			r_ret = get_pose_write_bone_name(index);
+			return true;
+		} else if (what == "pose_write_translation_epsilon") {
+			r_ret = get_pose_write_bone_translation_epsilon(index);
+			return true;
+		} else if (what == "pose_write_rotation_epsilon") {
+			r_ret = get_pose_write_bone_rotation_epsilon(index);
+			return true;
+		}
 	} else if (name.begins_with("pins/")) {
 		int index = name.get_slicec('/', 1).to_int();
 		String what = name.get_slicec('/', 2);
@@ -265,6 +691,9 @@ bool EWBIK3D::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "direction_priorities") {
 			r_ret = get_pin_direction_priorities(index);
 			return true;
+		} else if (what == "root_bone") {
+			r_ret = get_pin_root_bone(index);
+			return true;
 		}
 	} else if (name.begins_with("constraints/")) {
 		int index = name.get_slicec('/', 1).to_int();
@@ -317,6 +746,25 @@ bool EWBIK3D::_set(const StringName &p_name, const Variant &p_value) {
 	} else if (name == "pin_count") {
 		set_pin_count(p_value);
 		return true;
+	} else if (name == "pose_write_bone_count") {
+		set_pose_write_bone_count(p_value);
+		return true;
+	} else if (name.begins_with("bones/")) {
+		int index = name.get_slicec('/', 1).to_int();
+		String what = name.get_slicec('/', 2);
+		if (index >= pose_write_bone_count) {
+			set_pose_write_bone_count(index + 1);
+		}
+		if (what == "bone_name") {
+			set_pose_write_bone_name(index, p_value);
+			return true;
+		} else if (what == "pose_write_translation_epsilon") {
+			set_pose_write_bone_translation_epsilon(index, p_value);
+			return true;
+		} else if (what == "pose_write_rotation_epsilon") {
+			set_pose_write_bone_rotation_epsilon(index, p_value);
+			return true;
+		}
 	} else if (name.begins_with("pins/")) {
 		int index = name.get_slicec('/', 1).to_int();
 		String what = name.get_slicec('/', 2);
@@ -338,6 +786,9 @@ bool EWBIK3D::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (what == "direction_priorities") {
 			set_pin_direction_priorities(index, p_value);
 			return true;
+		} else if (what == "root_bone") {
+			set_pin_root_bone(index, p_value);
+			return true;
 		}
 	} else if (name.begins_with("constraints/")) {
 		int index = name.get_slicec('/', 1).to_int();
@@ -409,6 +860,8 @@ void EWBIK3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_joint_twist", "index"), &EWBIK3D::get_joint_twist);
 	ClassDB::bind_method(D_METHOD("set_pin_motion_propagation_factor", "index", "falloff"), &EWBIK3D::set_pin_motion_propagation_factor);
 	ClassDB::bind_method(D_METHOD("get_pin_motion_propagation_factor", "index"), &EWBIK3D::get_pin_motion_propagation_factor);
+	ClassDB::bind_method(D_METHOD("set_pin_root_bone", "index", "root_bone"), &EWBIK3D::set_pin_root_bone);
+	ClassDB::bind_method(D_METHOD("get_pin_root_bone", "index"), &EWBIK3D::get_pin_root_bone);
 	ClassDB::bind_method(D_METHOD("get_pin_count"), &EWBIK3D::get_pin_count);
 	ClassDB::bind_method(D_METHOD("set_pin_count", "count"), &EWBIK3D::set_pin_count);
 
@@ -436,35 +889,151 @@ void EWBIK3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_ui_selected_bone"), &EWBIK3D::get_ui_selected_bone);
 	ClassDB::bind_method(D_METHOD("set_stabilization_passes", "passes"), &EWBIK3D::set_stabilization_passes);
 	ClassDB::bind_method(D_METHOD("get_stabilization_passes"), &EWBIK3D::get_stabilization_passes);
+	ClassDB::bind_method(D_METHOD("set_two_bone_fast_path", "enabled"), &EWBIK3D::set_two_bone_fast_path);
+	ClassDB::bind_method(D_METHOD("get_two_bone_fast_path"), &EWBIK3D::get_two_bone_fast_path);
+	ClassDB::bind_method(D_METHOD("set_solver_backend", "backend"), &EWBIK3D::set_solver_backend);
+	ClassDB::bind_method(D_METHOD("get_solver_backend"), &EWBIK3D::get_solver_backend);
+	ClassDB::bind_method(D_METHOD("set_segment_solver_backend", "root_bone", "backend"), &EWBIK3D::set_segment_solver_backend);
+	ClassDB::bind_method(D_METHOD("clear_segment_solver_backend", "root_bone"), &EWBIK3D::clear_segment_solver_backend);
+	ClassDB::bind_method(D_METHOD("get_segment_solver_backend", "root_bone"), &EWBIK3D::get_segment_solver_backend);
+	ClassDB::bind_method(D_METHOD("set_segment_solver_backends", "backends"), &EWBIK3D::set_segment_solver_backends);
+	ClassDB::bind_method(D_METHOD("get_segment_solver_backends"), &EWBIK3D::get_segment_solver_backends);
+	ClassDB::bind_method(D_METHOD("set_bone_update_mode", "mode"), &EWBIK3D::set_bone_update_mode);
+	ClassDB::bind_method(D_METHOD("get_bone_update_mode"), &EWBIK3D::get_bone_update_mode);
+	ClassDB::bind_method(D_METHOD("set_jacobi_relaxation", "relaxation"), &EWBIK3D::set_jacobi_relaxation);
+	ClassDB::bind_method(D_METHOD("get_jacobi_relaxation"), &EWBIK3D::get_jacobi_relaxation);
+	ClassDB::bind_method(D_METHOD("set_pose_write_translation_epsilon", "epsilon"), &EWBIK3D::set_pose_write_translation_epsilon);
+	ClassDB::bind_method(D_METHOD("get_pose_write_translation_epsilon"), &EWBIK3D::get_pose_write_translation_epsilon);
+	ClassDB::bind_method(D_METHOD("set_pose_write_rotation_epsilon", "epsilon"), &EWBIK3D::set_pose_write_rotation_epsilon);
+	ClassDB::bind_method(D_METHOD("get_pose_write_rotation_epsilon"), &EWBIK3D::get_pose_write_rotation_epsilon);
+	ClassDB::bind_method(D_METHOD("set_pose_write_bone_count", "count"), &EWBIK3D::set_pose_write_bone_count);
+	ClassDB::bind_method(D_METHOD("get_pose_write_bone_count"), &EWBIK3D::get_pose_write_bone_count);
+	ClassDB::bind_method(D_METHOD("set_pose_write_bone_name", "index", "bone_name"), &EWBIK3D::set_pose_write_bone_name);
+	ClassDB::bind_method(D_METHOD("get_pose_write_bone_name", "index"), &EWBIK3D::get_pose_write_bone_name);
+	ClassDB::bind_method(D_METHOD("set_pose_write_bone_translation_epsilon", "index", "epsilon"), &EWBIK3D::set_pose_write_bone_translation_epsilon);
+	ClassDB::bind_method(D_METHOD("get_pose_write_bone_translation_epsilon", "index"), &EWBIK3D::get_pose_write_bone_translation_epsilon);
+	ClassDB::bind_method(D_METHOD("set_pose_write_bone_rotation_epsilon", "index", "epsilon"), &EWBIK3D::set_pose_write_bone_rotation_epsilon);
+	ClassDB::bind_method(D_METHOD("get_pose_write_bone_rotation_epsilon", "index"), &EWBIK3D::get_pose_write_bone_rotation_epsilon);
+	ClassDB::bind_method(D_METHOD("get_last_written_bone_count"), &EWBIK3D::get_last_written_bone_count);
+	ClassDB::bind_method(D_METHOD("set_pin_target_transform", "index", "transform", "space"), &EWBIK3D::set_pin_target_transform, DEFVAL(PIN_TARGET_SPACE_SKELETON));
+	ClassDB::bind_method(D_METHOD("set_pin_target_transforms", "transforms", "space"), &EWBIK3D::set_pin_target_transforms, DEFVAL(PIN_TARGET_SPACE_SKELETON));
+	ClassDB::bind_method(D_METHOD("get_pin_target_transform", "index"), &EWBIK3D::get_pin_target_transform);
+	ClassDB::bind_method(D_METHOD("clear_pin_target_transform", "index"), &EWBIK3D::clear_pin_target_transform);
+	ClassDB::bind_method(D_METHOD("is_pin_target_transform_enabled", "index"), &EWBIK3D::is_pin_target_transform_enabled);
+	ClassDB::bind_method(D_METHOD("push_pin_target", "index", "transform", "timestamp", "space"), &EWBIK3D::push_pin_target, DEFVAL(PIN_TARGET_SPACE_SKELETON));
+	ClassDB::bind_method(D_METHOD("set_async_solve", "enabled"), &EWBIK3D::set_async_solve);
+	ClassDB::bind_method(D_METHOD("get_async_solve"), &EWBIK3D::get_async_solve);
+	ClassDB::bind_method(D_METHOD("is_async_solve_running"), &EWBIK3D::is_async_solve_running);
+	ClassDB::bind_method(D_METHOD("set_solve_rate", "rate"), &EWBIK3D::set_solve_rate);
+	ClassDB::bind_method(D_METHOD("get_solve_rate"), &EWBIK3D::get_solve_rate);
+	ClassDB::bind_method(D_METHOD("set_fast_target_speed", "speed"), &EWBIK3D::set_fast_target_speed);
+	ClassDB::bind_method(D_METHOD("get_fast_target_speed"), &EWBIK3D::get_fast_target_speed);
+	ClassDB::bind_method(D_METHOD("set_solve_scheduler", "scheduler"), &EWBIK3D::set_solve_scheduler);
+	ClassDB::bind_method(D_METHOD("get_solve_scheduler"), &EWBIK3D::get_solve_scheduler);
+	ClassDB::bind_method(D_METHOD("set_lod_metric", "metric"), &EWBIK3D::set_lod_metric);
+	ClassDB::bind_method(D_METHOD("get_lod_metric"), &EWBIK3D::get_lod_metric);
+	ClassDB::bind_method(D_METHOD("set_lod_thresholds", "thresholds"), &EWBIK3D::set_lod_thresholds);
+	ClassDB::bind_method(D_METHOD("get_lod_thresholds"), &EWBIK3D::get_lod_thresholds);
+	ClassDB::bind_method(D_METHOD("set_lod_hysteresis", "hysteresis"), &EWBIK3D::set_lod_hysteresis);
+	ClassDB::bind_method(D_METHOD("get_lod_hysteresis"), &EWBIK3D::get_lod_hysteresis);
+	ClassDB::bind_method(D_METHOD("set_lod_min_pin_weight", "weight"), &EWBIK3D::set_lod_min_pin_weight);
+	ClassDB::bind_method(D_METHOD("get_lod_min_pin_weight"), &EWBIK3D::get_lod_min_pin_weight);
+	ClassDB::bind_method(D_METHOD("set_lod_freeze_depth", "depth"), &EWBIK3D::set_lod_freeze_depth);
+	ClassDB::bind_method(D_METHOD("get_lod_freeze_depth"), &EWBIK3D::get_lod_freeze_depth);
+	ClassDB::bind_method(D_METHOD("get_lod_tier"), &EWBIK3D::get_lod_tier);
+	ClassDB::bind_method(D_METHOD("set_sleep_translation_threshold", "threshold"), &EWBIK3D::set_sleep_translation_threshold);
+	ClassDB::bind_method(D_METHOD("get_sleep_translation_threshold"), &EWBIK3D::get_sleep_translation_threshold);
+	ClassDB::bind_method(D_METHOD("set_sleep_rotation_threshold", "threshold"), &EWBIK3D::set_sleep_rotation_threshold);
+	ClassDB::bind_method(D_METHOD("get_sleep_rotation_threshold"), &EWBIK3D::get_sleep_rotation_threshold);
+	ClassDB::bind_method(D_METHOD("is_sleeping"), &EWBIK3D::is_sleeping);
+	ClassDB::bind_method(D_METHOD("get_sleeping_frame_count"), &EWBIK3D::get_sleeping_frame_count);
+	ClassDB::bind_method(D_METHOD("get_solved_frame_count"), &EWBIK3D::get_solved_frame_count);
+	ClassDB::bind_method(D_METHOD("reset_frame_counts"), &EWBIK3D::reset_frame_counts);
+	ClassDB::bind_method(D_METHOD("set_root_bone", "bone"), &EWBIK3D::set_root_bone);
+	ClassDB::bind_method(D_METHOD("get_root_bone"), &EWBIK3D::get_root_bone);
+	ClassDB::bind_method(D_METHOD("set_tip_bone", "bone"), &EWBIK3D::set_tip_bone);
+	ClassDB::bind_method(D_METHOD("get_tip_bone"), &EWBIK3D::get_tip_bone);
+	ClassDB::bind_method(D_METHOD("is_bone_in_scope", "bone"), &EWBIK3D::is_bone_in_scope);
+	ClassDB::bind_method(D_METHOD("set_partial_solve", "enabled"), &EWBIK3D::set_partial_solve);
+	ClassDB::bind_method(D_METHOD("get_partial_solve"), &EWBIK3D::get_partial_solve);
+	ClassDB::bind_method(D_METHOD("get_last_solved_segment_count"), &EWBIK3D::get_last_solved_segment_count);
+	ClassDB::bind_method(D_METHOD("get_solved_pose"), &EWBIK3D::get_solved_pose);
+	ClassDB::bind_method(D_METHOD("get_solved_pose_version"), &EWBIK3D::get_solved_pose_version);
+	ClassDB::bind_method(D_METHOD("set_pin_target_queue_capacity", "capacity"), &EWBIK3D::set_pin_target_queue_capacity);
+	ClassDB::bind_method(D_METHOD("get_pin_target_queue_capacity"), &EWBIK3D::get_pin_target_queue_capacity);
+	ClassDB::bind_method(D_METHOD("set_pin_target_interpolation_delay", "delay"), &EWBIK3D::set_pin_target_interpolation_delay);
+	ClassDB::bind_method(D_METHOD("get_pin_target_interpolation_delay"), &EWBIK3D::get_pin_target_interpolation_delay);
 	ClassDB::bind_method(D_METHOD("set_effector_bone_name", "index", "name"), &EWBIK3D::set_pin_bone_name);
 
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "root_bone"), "set_root_bone", "get_root_bone");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "tip_bone"), "set_tip_bone", "get_tip_bone");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "iterations_per_frame", PROPERTY_HINT_RANGE, "1,150,1,or_greater"), "set_iterations_per_frame", "get_iterations_per_frame");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "default_damp", PROPERTY_HINT_RANGE, "0.01,180.0,0.1,radians,exp", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), "set_default_damp", "get_default_damp");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "constraint_mode"), "set_constraint_mode", "get_constraint_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "ui_selected_bone", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_ui_selected_bone", "get_ui_selected_bone");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "stabilization_passes"), "set_stabilization_passes", "get_stabilization_passes");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "two_bone_fast_path"), "set_two_bone_fast_path", "get_two_bone_fast_path");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "solver_backend", PROPERTY_HINT_ENUM, "QCP,FABRIK,Damped Least Squares"), "set_solver_backend", "get_solver_backend");
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "segment_solver_backends"), "set_segment_solver_backends", "get_segment_solver_backends");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "bone_update_mode", PROPERTY_HINT_ENUM, "Gauss-Seidel,Jacobi"), "set_bone_update_mode", "get_bone_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "jacobi_relaxation", PROPERTY_HINT_RANGE, "0.01,4,0.01"), "set_jacobi_relaxation", "get_jacobi_relaxation");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pose_write_translation_epsilon", PROPERTY_HINT_RANGE, "0,0.1,0.0001,or_greater,suffix:m"), "set_pose_write_translation_epsilon", "get_pose_write_translation_epsilon");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pose_write_rotation_epsilon", PROPERTY_HINT_RANGE, "0,10,0.01,radians"), "set_pose_write_rotation_epsilon", "get_pose_write_rotation_epsilon");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "async_solve"), "set_async_solve", "get_async_solve");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "solve_rate", PROPERTY_HINT_RANGE, "0,120,1,or_greater,suffix:Hz"), "set_solve_rate", "get_solve_rate");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "solve_scheduler", PROPERTY_HINT_RESOURCE_TYPE, "IKSolveScheduler3D"), "set_solve_scheduler", "get_solve_scheduler");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "fast_target_speed", PROPERTY_HINT_RANGE, "0,20,0.01,or_greater,suffix:m/s"), "set_fast_target_speed", "get_fast_target_speed");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "partial_solve"), "set_partial_solve", "get_partial_solve");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sleep_translation_threshold", PROPERTY_HINT_RANGE, "0,0.01,0.00001,or_greater,suffix:m"), "set_sleep_translation_threshold", "get_sleep_translation_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sleep_rotation_threshold", PROPERTY_HINT_RANGE, "0,1,0.0001,or_greater,radians"), "set_sleep_rotation_threshold", "get_sleep_rotation_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_metric", PROPERTY_HINT_ENUM, "Distance,Screen Size"), "set_lod_metric", "get_lod_metric");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "lod_thresholds"), "set_lod_thresholds", "get_lod_thresholds");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_hysteresis", PROPERTY_HINT_RANGE, "0,0.5,0.01"), "set_lod_hysteresis", "get_lod_hysteresis");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_min_pin_weight", PROPERTY_HINT_RANGE, "0,1,0.01,or_greater"), "set_lod_min_pin_weight", "get_lod_min_pin_weight");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_freeze_depth", PROPERTY_HINT_RANGE, "0,8,1,or_greater"), "set_lod_freeze_depth", "get_lod_freeze_depth");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pin_target_queue_capacity", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"), "set_pin_target_queue_capacity", "get_pin_target_queue_capacity");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pin_target_interpolation_delay", PROPERTY_HINT_RANGE, "0,0.2,0.001,or_greater,suffix:s"), "set_pin_target_interpolation_delay", "get_pin_target_interpolation_delay");
+
+	BIND_ENUM_CONSTANT(SOLVER_BACKEND_QCP);
+	BIND_ENUM_CONSTANT(SOLVER_BACKEND_FABRIK);
+	BIND_ENUM_CONSTANT(SOLVER_BACKEND_DAMPED_LEAST_SQUARES);
+	BIND_ENUM_CONSTANT(BONE_UPDATE_GAUSS_SEIDEL);
+	BIND_ENUM_CONSTANT(BONE_UPDATE_JACOBI);
+	BIND_ENUM_CONSTANT(PIN_TARGET_SPACE_SKELETON);
+	BIND_ENUM_CONSTANT(PIN_TARGET_SPACE_WORLD);
+	BIND_ENUM_CONSTANT(LOD_METRIC_DISTANCE);
+	BIND_ENUM_CONSTANT(LOD_METRIC_SCREEN_SIZE);
 }
 
 EWBIK3D::EWBIK3D() {
+	set_pin_target_queue_capacity(256);
 }
 
 void EWBIK3D::cleanup() {
 	// Force immediate cleanup of all resources
 	set_active(false); // Stop any processing
+	_finish_async_solve(true);
 
 	// Clear all collections to break cycles
 	bone_list.clear();
 	segmented_skeletons.clear();
+	segment_root_parents.clear();
 	pins.clear();
 
 	is_dirty = true;
 }
 
 EWBIK3D::~EWBIK3D() {
+	_finish_async_solve(true);
+	if (solve_scheduler.is_valid()) {
+		solve_scheduler->remove_instance(this);
+	}
 	// Clear all collections - Ref<> objects handle their own cleanup automatically
 	segmented_skeletons.clear();
+	segment_root_parents.clear();
 	bone_list.clear();
 	pins.clear();
+	pin_effectors.clear();
 
 	// Clear constraint data
 	constraint_names.clear();
@@ -492,6 +1061,21 @@ void EWBIK3D::set_pin_motion_propagation_factor(int32_t p_effector_index, const
 	set_dirty();
 }
 
+void EWBIK3D::set_pin_root_bone(int32_t p_pin_index, const StringName &p_root_bone) {
+	ERR_FAIL_INDEX(p_pin_index, pins.size());
+	Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND(effector_template.is_null());
+	effector_template->set_root_bone(p_root_bone);
+	set_dirty();
+}
+
+StringName EWBIK3D::get_pin_root_bone(int32_t p_pin_index) const {
+	ERR_FAIL_INDEX_V(p_pin_index, pins.size(), StringName());
+	const Ref<IKEffectorTemplate3D> effector_template = pins[p_pin_index];
+	ERR_FAIL_COND_V(effector_template.is_null(), StringName());
+	return effector_template->get_root_bone();
+}
+
 void EWBIK3D::_set_constraint_count(int32_t p_count) {
 	int32_t old_count = constraint_names.size();
 	constraint_count = p_count;
@@ -692,13 +1276,16 @@ void EWBIK3D::_process_modification(double p_delta) {
 		is_dirty = false;
 		_bone_list_changed();
 	}
+	_drain_pin_target_queue();
 	if (bone_list.size()) {
 		Ref<IKNode3D> root_ik_bone = bone_list.write[0]->get_ik_transform();
 		if (root_ik_bone.is_null()) {
 			return;
 		}
 		Skeleton3D *skeleton = get_skeleton();
-		godot_skeleton_transform.instantiate();
+		if (godot_skeleton_transform.is_null()) {
+			godot_skeleton_transform.instantiate();
+		}
 		godot_skeleton_transform->set_transform(skeleton->get_transform());
 		godot_skeleton_transform_inverse = skeleton->get_transform().affine_inverse();
 	}
@@ -708,15 +1295,253 @@ void EWBIK3D::_process_modification(double p_delta) {
 	if (!is_visible()) {
 		return;
 	}
-	for (int32_t i = 0; i < get_iterations_per_frame(); i++) {
-		for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
-			if (segmented_skeleton.is_null()) {
+	_update_lod_tier();
+	if (lod_apply_pending && async_solve_task == WorkerThreadPool::INVALID_TASK_ID) {
+		_apply_lod_to_segments();
+	}
+	// A scheduled instance only solves in its phase; a missed solve_rate tick waits for the next one.
+	bool scheduled = true;
+	if (solve_scheduler.is_valid()) {
+		const bool physics = get_skeleton()->get_modifier_callback_mode_process() == Skeleton3D::MODIFIER_CALLBACK_MODE_PROCESS_PHYSICS;
+		scheduled = solve_scheduler->is_solve_frame(this, physics ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_process_frames());
+	}
+	if (solve_rate > 0.0f) {
+		solve_time += p_delta;
+	}
+	bool fast = false;
+	bool solve_due = scheduled && (solve_rate <= 0.0f || _consume_solve_tick(fast));
+	// The solve would repeat the last result, so the cached one is applied instead.
+	sleeping = solve_due && _is_sleep_enabled() && async_solve_task == WorkerThreadPool::INVALID_TASK_ID && _is_solve_input_unchanged();
+	if (sleeping) {
+		solve_due = false;
+		sleeping_frame_count++;
+	} else if (solve_due) {
+		solved_frame_count++;
+	}
+	if (async_solve) {
+		// Apply the newest completed solve and start the next one, but never wait for a solve still running.
+		if (async_solve_task != WorkerThreadPool::INVALID_TASK_ID && WorkerThreadPool::get_singleton()->is_task_completed(async_solve_task)) {
+			_finish_async_solve();
+		}
+		_write_bone_poses(async_poses[async_front_poses]);
+		if (async_solve_task == WorkerThreadPool::INVALID_TASK_ID && solve_due) {
+			_launch_async_solve();
+		}
+		return;
+	}
+	if (solve_rate > 0.0f || solve_scheduler.is_valid()) {
+		_solve_tick(solve_due || !tick_poses_valid, fast);
+		return;
+	}
+	if (sleeping) {
+		_write_bone_poses(sleep_poses);
+		return;
+	}
+	_prepare_segment_solve();
+	_solve(_get_solve_iterations());
+	_update_skeleton_bones_transform();
+	if (_is_sleep_enabled()) {
+		sleep_poses = bone_poses;
+	}
+}
+
+int32_t EWBIK3D::_get_solve_iterations() const {
+	return MAX(1, int32_t(get_iterations_per_frame()) >> lod_tier);
+}
+
+void EWBIK3D::_prepare_segment_solve() {
+	// A partial solve skips the segments that see none of the pins moved since the last solve.
+	last_solved_segment_count = 0;
+	for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_valid()) {
+			last_solved_segment_count += segmented_skeleton->update_solve_pending(!partial_solve);
+		}
+	}
+	for (int32_t pin_i : moved_pins) {
+		pin_effectors[pin_i]->set_target_moved(false);
+	}
+	moved_pins.clear();
+}
+
+void EWBIK3D::_mark_pin_moved(int32_t p_pin_index) {
+	const Ref<IKEffector3D> &effector = pin_effectors[p_pin_index];
+	if (!effector->is_target_moved()) {
+		effector->set_target_moved(true);
+		moved_pins.push_back(p_pin_index);
+	}
+}
+
+static bool _is_transform_moved(const Transform3D &p_a, const Transform3D &p_b, real_t p_offset_epsilon_squared, real_t p_rotation_cos_half_epsilon) {
+	// Like the pose write epsilons, nothing scales bones on its own, so any change of scale counts.
+	return p_a.origin.distance_squared_to(p_b.origin) > p_offset_epsilon_squared ||
+			Math::abs(p_a.basis.get_rotation_quaternion().dot(p_b.basis.get_rotation_quaternion())) < p_rotation_cos_half_epsilon ||
+			!p_a.basis.get_scale().is_equal_approx(p_b.basis.get_scale());
+}
+
+bool EWBIK3D::_is_sleep_enabled() const {
+	return sleep_translation_threshold > 0.0f || sleep_rotation_threshold > 0.0f;
+}
+
+bool EWBIK3D::_is_solve_input_unchanged() {
+	Skeleton3D *skeleton = get_skeleton();
+	const real_t offset_epsilon_squared = sleep_translation_threshold * sleep_translation_threshold;
+	const real_t rotation_cos_half_epsilon = Math::cos(MIN(sleep_rotation_threshold, float(Math::PI)) * 0.5f);
+	// Walks everything even after the first change, so the inputs of the solve about to run are all recorded.
+	bool unchanged = sleep_input_poses.size() == uint32_t(bone_list.size()) && sleep_targets.size() == uint32_t(pin_effectors.size());
+	sleep_input_poses.resize(bone_list.size());
+	for (int32_t bone_i = 0; bone_i < bone_list.size(); bone_i++) {
+		const Ref<IKBone3D> &bone = bone_list[bone_i];
+		if (bone.is_null() || bone->get_bone_id() == -1) {
+			continue;
+		}
+		const Transform3D pose = skeleton->get_bone_pose(bone->get_bone_id());
+		if (_is_transform_moved(pose, sleep_input_poses[bone_i], offset_epsilon_squared, rotation_cos_half_epsilon)) {
+			unchanged = false;
+			sleep_input_poses[bone_i] = pose;
+		}
+	}
+	// Only the pins queued since the last solve can differ from the recorded targets, unless nothing was recorded yet.
+	if (sleep_targets.size() != uint32_t(pin_effectors.size())) {
+		sleep_targets.resize(pin_effectors.size());
+		for (int32_t pin_i = 0; pin_i < pin_effectors.size(); pin_i++) {
+			if (pin_effectors[pin_i].is_valid()) {
+				sleep_targets[pin_i] = pin_effectors[pin_i]->get_target_global_transform();
+			}
+		}
+	}
+	for (int32_t pin_i : moved_pins) {
+		const Transform3D target = pin_effectors[pin_i]->get_target_global_transform();
+		if (_is_transform_moved(target, sleep_targets[pin_i], offset_epsilon_squared, rotation_cos_half_epsilon)) {
+			unchanged = false;
+			sleep_targets[pin_i] = target;
+		}
+	}
+	// Without a cached result there is nothing to apply in place of the solve.
+	return unchanged && (async_solve || solve_rate > 0.0f || solve_scheduler.is_valid() || sleep_poses.size() == uint32_t(bone_list.size()));
+}
+
+void EWBIK3D::_update_lod_tier() {
+	if (lod_thresholds.is_empty()) {
+		if (lod_tier != 0) {
+			_set_lod_tier(0);
+		}
+		return;
+	}
+	const Viewport *viewport = get_viewport();
+	const Camera3D *camera = viewport ? viewport->get_camera_3d() : nullptr;
+	if (!camera) {
+		return;
+	}
+	const real_t distance = camera->get_global_position().distance_to(get_skeleton()->get_global_position());
+	// Both metrics grow toward the coarser tiers: the distance, or how small the skeleton's reach is on screen.
+	real_t value = distance;
+	real_t sign = 1.0;
+	if (lod_metric == LOD_METRIC_SCREEN_SIZE) {
+		const real_t half_view = camera->get_projection() == Camera3D::PROJECTION_ORTHOGONAL ? camera->get_size() * 0.5 : distance * Math::tan(Math::deg_to_rad(camera->get_fov()) * 0.5);
+		value = lod_radius / MAX(half_view, real_t(CMP_EPSILON));
+		sign = -1.0;
+	}
+	// A tier is only left once the value is past its threshold by the hysteresis, so tiers do not flicker at a threshold.
+	int32_t tier = CLAMP(lod_tier, 0, lod_thresholds.size());
+	while (tier < lod_thresholds.size() && sign * value > sign * lod_thresholds[tier] * (1.0 + sign * lod_hysteresis)) {
+		tier++;
+	}
+	while (tier > 0 && sign * value < sign * lod_thresholds[tier - 1] * (1.0 - sign * lod_hysteresis)) {
+		tier--;
+	}
+	if (tier != lod_tier) {
+		_set_lod_tier(tier);
+	}
+}
+
+void EWBIK3D::_set_lod_tier(int32_t p_tier) {
+	lod_tier = p_tier;
+	_apply_lod_to_segments();
+}
+
+void EWBIK3D::_apply_lod_to_segments() {
+	if (async_solve_task != WorkerThreadPool::INVALID_TASK_ID) {
+		// The worker reads the segments; the tier is applied before the next launch.
+		lod_apply_pending = true;
+		return;
+	}
+	lod_apply_pending = false;
+	// Light pins are skipped in place rather than rebuilt away, so crossing tier 1 keeps the bones and the last pose.
+	bool pins_changed = false;
+	for (int32_t pin_i = 0; pin_i < pin_effectors.size() && pin_i < pins.size(); pin_i++) {
+		const Ref<IKEffector3D> &effector = pin_effectors[pin_i];
+		if (effector.is_null() || pins[pin_i].is_null()) {
+			continue;
+		}
+		const bool skipped = lod_tier >= 1 && pins[pin_i]->get_weight() < lod_min_pin_weight;
+		if (effector->is_lod_skipped() != skipped) {
+			effector->set_lod_skipped(skipped);
+			pins_changed = true;
+		}
+	}
+	for (Ref<IKBoneSegment3D> segmented_skeleton : segmented_skeletons) {
+		if (segmented_skeleton.is_null()) {
+			continue;
+		}
+		segmented_skeleton->set_lod(lod_tier < 1, lod_tier >= 2 ? lod_freeze_depth : -1);
+		if (pins_changed) {
+			segmented_skeleton->update_solved_pins();
+		}
+	}
+}
+
+bool EWBIK3D::_consume_solve_tick(bool &r_fast) {
+	r_fast = false;
+	// Pin targets that outrun fast_target_speed are solved every frame until they slow down.
+	if (fast_target_speed > 0.0f && async_solve_task == WorkerThreadPool::INVALID_TASK_ID) {
+		const bool had_origins = tick_target_origins.size() == uint32_t(pin_effectors.size());
+		tick_target_origins.resize(pin_effectors.size());
+		const real_t max_distance = fast_target_speed * solve_time;
+		for (int32_t pin_i = 0; pin_i < pin_effectors.size(); pin_i++) {
+			if (pin_effectors[pin_i].is_null()) {
 				continue;
 			}
-			segmented_skeleton->segment_solver(bone_damp, get_default_damp(), get_constraint_mode(), i, get_iterations_per_frame());
+			const Vector3 origin = pin_effectors[pin_i]->get_target_global_transform().origin;
+			r_fast = r_fast || (had_origins && origin.distance_to(tick_target_origins[pin_i]) > max_distance);
 		}
 	}
-	_update_skeleton_bones_transform();
+	const double interval = 1.0 / solve_rate;
+	if (!r_fast && solve_time < interval) {
+		return false;
+	}
+	// A long frame owes at most one more solve, rather than a burst of them.
+	solve_time = r_fast ? 0.0 : MIN(solve_time - interval, interval);
+	for (int32_t pin_i = 0; pin_i < pin_effectors.size() && pin_i < int32_t(tick_target_origins.size()); pin_i++) {
+		if (pin_effectors[pin_i].is_valid()) {
+			tick_target_origins[pin_i] = pin_effectors[pin_i]->get_target_global_transform().origin;
+		}
+	}
+	return true;
+}
+
+void EWBIK3D::_solve_tick(bool p_solve, bool p_fast) {
+	if (p_solve) {
+		_prepare_segment_solve();
+		_solve(_get_solve_iterations());
+		tick_current = 1 - tick_current;
+		_gather_bone_poses(tick_poses[tick_current]);
+		_publish_bone_poses(tick_poses[tick_current]);
+		if (!tick_poses_valid || p_fast) {
+			// Nothing to blend from yet, or the target moved too fast to trail it: show this solve as is.
+			tick_poses[1 - tick_current] = tick_poses[tick_current];
+			tick_poses_valid = true;
+		}
+	}
+	// Blend the two newest solves by how far the clock is toward the next one, which trails the solver by one solve.
+	// Without a solve rate, frames skipped by the scheduler hold the newest solve.
+	const LocalVector<Transform3D> &from = tick_poses[1 - tick_current];
+	const LocalVector<Transform3D> &to = tick_poses[tick_current];
+	const real_t weight = solve_rate > 0.0f ? CLAMP(solve_time * solve_rate, 0.0, 1.0) : 1.0;
+	bone_poses.resize(to.size());
+	for (uint32_t bone_i = 0; bone_i < to.size(); bone_i++) {
+		bone_poses[bone_i] = from[bone_i].interpolate_with(to[bone_i], weight);
+	}
+	_write_bone_poses(bone_poses);
 }
 
 real_t EWBIK3D::get_pin_weight(int32_t p_pin_index) const {
@@ -780,6 +1605,7 @@ void EWBIK3D::remove_pin_at_index(int32_t p_index) {
 }
 
 void EWBIK3D::_set_bone_count(int32_t p_count) {
+	_finish_async_solve();
 	bone_damp.resize(p_count);
 	for (int32_t bone_i = p_count; bone_i-- > bone_count;) {
 		bone_damp.write[bone_i] = get_default_damp();
@@ -799,6 +1625,7 @@ Vector<Ref<IKBone3D>> EWBIK3D::get_bone_list() const {
 
 void EWBIK3D::set_direction_transform_of_bone(int32_t p_index, Transform3D p_transform) {
 	ERR_FAIL_INDEX(p_index, constraint_names.size());
+	_finish_async_solve();
 	if (!get_skeleton()) {
 		return;
 	}
@@ -867,6 +1694,7 @@ Transform3D EWBIK3D::get_orientation_transform_of_constraint(int32_t p_index) co
 
 void EWBIK3D::set_orientation_transform_of_constraint(int32_t p_index, Transform3D p_transform) {
 	ERR_FAIL_INDEX(p_index, constraint_names.size());
+	_finish_async_solve();
 	String bone_name = constraint_names[p_index];
 	if (!get_skeleton()) {
 		return;
@@ -914,6 +1742,7 @@ Transform3D EWBIK3D::get_twist_transform_of_constraint(int32_t p_index) const {
 
 void EWBIK3D::set_twist_transform_of_constraint(int32_t p_index, Transform3D p_transform) {
 	ERR_FAIL_INDEX(p_index, constraint_names.size());
+	_finish_async_solve();
 	String bone_name = constraint_names[p_index];
 	if (!get_skeleton()) {
 		return;
@@ -990,6 +1819,431 @@ int32_t EWBIK3D::get_stabilization_passes() {
 	return stabilize_passes;
 }
 
+void EWBIK3D::set_two_bone_fast_path(bool p_enabled) {
+	two_bone_fast_path = p_enabled;
+	set_dirty();
+}
+
+bool EWBIK3D::get_two_bone_fast_path() const {
+	return two_bone_fast_path;
+}
+
+void EWBIK3D::set_solver_backend(SolverBackend p_backend) {
+	solver_backend = p_backend;
+	set_dirty();
+}
+
+EWBIK3D::SolverBackend EWBIK3D::get_solver_backend() const {
+	return solver_backend;
+}
+
+void EWBIK3D::set_segment_solver_backend(const StringName &p_root_bone, SolverBackend p_backend) {
+	segment_solver_backends[String(p_root_bone)] = p_backend;
+	set_dirty();
+}
+
+void EWBIK3D::clear_segment_solver_backend(const StringName &p_root_bone) {
+	segment_solver_backends.erase(String(p_root_bone));
+	set_dirty();
+}
+
+EWBIK3D::SolverBackend EWBIK3D::get_segment_solver_backend(const StringName &p_root_bone) const {
+	const Variant *backend = segment_solver_backends.getptr(String(p_root_bone));
+	if (!backend) {
+		return solver_backend;
+	}
+	return SolverBackend(CLAMP(int32_t(*backend), int32_t(SOLVER_BACKEND_QCP), int32_t(SOLVER_BACKEND_DAMPED_LEAST_SQUARES)));
+}
+
+void EWBIK3D::set_segment_solver_backends(const Dictionary &p_backends) {
+	segment_solver_backends = p_backends.duplicate();
+	set_dirty();
+}
+
+Dictionary EWBIK3D::get_segment_solver_backends() const {
+	return segment_solver_backends;
+}
+
+void EWBIK3D::set_bone_update_mode(BoneUpdateMode p_mode) {
+	bone_update_mode = p_mode;
+	set_dirty();
+}
+
+EWBIK3D::BoneUpdateMode EWBIK3D::get_bone_update_mode() const {
+	return bone_update_mode;
+}
+
+void EWBIK3D::set_jacobi_relaxation(float p_relaxation) {
+	ERR_FAIL_COND_MSG(p_relaxation <= 0.0f, "Jacobi relaxation must be positive.");
+	jacobi_relaxation = p_relaxation;
+	set_dirty();
+}
+
+float EWBIK3D::get_jacobi_relaxation() const {
+	return jacobi_relaxation;
+}
+
+void EWBIK3D::set_pose_write_translation_epsilon(float p_epsilon) {
+	ERR_FAIL_COND_MSG(p_epsilon < 0.0f, "Pose write translation epsilon must not be negative.");
+	pose_write_translation_epsilon = p_epsilon;
+	bone_pose_write_thresholds_dirty = true;
+}
+
+float EWBIK3D::get_pose_write_translation_epsilon() const {
+	return pose_write_translation_epsilon;
+}
+
+void EWBIK3D::set_pose_write_rotation_epsilon(float p_epsilon) {
+	ERR_FAIL_COND_MSG(p_epsilon < 0.0f, "Pose write rotation epsilon must not be negative.");
+	pose_write_rotation_epsilon = p_epsilon;
+	bone_pose_write_thresholds_dirty = true;
+}
+
+float EWBIK3D::get_pose_write_rotation_epsilon() const {
+	return pose_write_rotation_epsilon;
+}
+
+void EWBIK3D::set_pose_write_bone_count(int32_t p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	const int32_t old_count = pose_write_bone_count;
+	pose_write_bone_count = p_count;
+	pose_write_bone_names.resize(p_count);
+	pose_write_bone_epsilons.resize(p_count);
+	for (int32_t override_i = old_count; override_i < p_count; override_i++) {
+		pose_write_bone_names.write[override_i] = StringName();
+		pose_write_bone_epsilons.write[override_i] = Vector2(-1.0f, -1.0f);
+	}
+	bone_pose_write_thresholds_dirty = true;
+	notify_property_list_changed();
+}
+
+int32_t EWBIK3D::get_pose_write_bone_count() const {
+	return pose_write_bone_count;
+}
+
+void EWBIK3D::set_pose_write_bone_name(int32_t p_index, const StringName &p_bone_name) {
+	ERR_FAIL_INDEX(p_index, pose_write_bone_count);
+	pose_write_bone_names.write[p_index] = p_bone_name;
+	bone_pose_write_thresholds_dirty = true;
+}
+
+StringName EWBIK3D::get_pose_write_bone_name(int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_index, pose_write_bone_count, StringName());
+	return pose_write_bone_names[p_index];
+}
+
+void EWBIK3D::set_pose_write_bone_translation_epsilon(int32_t p_index, float p_epsilon) {
+	ERR_FAIL_INDEX(p_index, pose_write_bone_count);
+	pose_write_bone_epsilons.write[p_index].x = p_epsilon;
+	bone_pose_write_thresholds_dirty = true;
+}
+
+float EWBIK3D::get_pose_write_bone_translation_epsilon(int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_index, pose_write_bone_count, -1.0f);
+	return pose_write_bone_epsilons[p_index].x;
+}
+
+void EWBIK3D::set_pose_write_bone_rotation_epsilon(int32_t p_index, float p_epsilon) {
+	ERR_FAIL_INDEX(p_index, pose_write_bone_count);
+	pose_write_bone_epsilons.write[p_index].y = p_epsilon;
+	bone_pose_write_thresholds_dirty = true;
+}
+
+float EWBIK3D::get_pose_write_bone_rotation_epsilon(int32_t p_index) const {
+	ERR_FAIL_INDEX_V(p_index, pose_write_bone_count, -1.0f);
+	return pose_write_bone_epsilons[p_index].y;
+}
+
+int32_t EWBIK3D::get_last_written_bone_count() const {
+	return last_written_bone_count;
+}
+
+void EWBIK3D::set_async_solve(bool p_enabled) {
+	if (!p_enabled) {
+		// The synchronous solve continues from the IK nodes, so the running solve has to let go of them first.
+		_finish_async_solve();
+	}
+	async_solve = p_enabled;
+}
+
+bool EWBIK3D::get_async_solve() const {
+	return async_solve;
+}
+
+bool EWBIK3D::is_async_solve_running() const {
+	return async_solve_task != WorkerThreadPool::INVALID_TASK_ID;
+}
+
+void EWBIK3D::set_solve_rate(float p_rate) {
+	ERR_FAIL_COND_MSG(p_rate < 0.0f, "Solve rate must not be negative.");
+	solve_rate = p_rate;
+	solve_time = 0.0;
+	tick_poses_valid = false;
+}
+
+float EWBIK3D::get_solve_rate() const {
+	return solve_rate;
+}
+
+void EWBIK3D::set_fast_target_speed(float p_speed) {
+	ERR_FAIL_COND_MSG(p_speed < 0.0f, "Fast target speed must not be negative.");
+	fast_target_speed = p_speed;
+}
+
+float EWBIK3D::get_fast_target_speed() const {
+	return fast_target_speed;
+}
+
+void EWBIK3D::set_solve_scheduler(const Ref<IKSolveScheduler3D> &p_scheduler) {
+	if (solve_scheduler == p_scheduler) {
+		return;
+	}
+	if (solve_scheduler.is_valid()) {
+		solve_scheduler->remove_instance(this);
+	}
+	solve_scheduler = p_scheduler;
+	if (solve_scheduler.is_valid()) {
+		solve_scheduler->add_instance(this);
+	}
+}
+
+Ref<IKSolveScheduler3D> EWBIK3D::get_solve_scheduler() const {
+	return solve_scheduler;
+}
+
+void EWBIK3D::set_lod_metric(LODMetric p_metric) {
+	lod_metric = p_metric;
+}
+
+EWBIK3D::LODMetric EWBIK3D::get_lod_metric() const {
+	return lod_metric;
+}
+
+void EWBIK3D::set_lod_thresholds(const PackedFloat32Array &p_thresholds) {
+	lod_thresholds = p_thresholds;
+}
+
+PackedFloat32Array EWBIK3D::get_lod_thresholds() const {
+	return lod_thresholds;
+}
+
+void EWBIK3D::set_lod_hysteresis(float p_hysteresis) {
+	ERR_FAIL_COND_MSG(p_hysteresis < 0.0f || p_hysteresis >= 1.0f, "LOD hysteresis must be at least 0 and below 1.");
+	lod_hysteresis = p_hysteresis;
+}
+
+float EWBIK3D::get_lod_hysteresis() const {
+	return lod_hysteresis;
+}
+
+void EWBIK3D::set_lod_min_pin_weight(float p_weight) {
+	lod_min_pin_weight = p_weight;
+	_apply_lod_to_segments();
+}
+
+float EWBIK3D::get_lod_min_pin_weight() const {
+	return lod_min_pin_weight;
+}
+
+void EWBIK3D::set_lod_freeze_depth(int32_t p_depth) {
+	ERR_FAIL_COND_MSG(p_depth < 0, "LOD freeze depth must not be negative.");
+	lod_freeze_depth = p_depth;
+	_apply_lod_to_segments();
+}
+
+int32_t EWBIK3D::get_lod_freeze_depth() const {
+	return lod_freeze_depth;
+}
+
+int32_t EWBIK3D::get_lod_tier() const {
+	return lod_tier;
+}
+
+void EWBIK3D::set_sleep_translation_threshold(float p_threshold) {
+	ERR_FAIL_COND_MSG(p_threshold < 0.0f, "Sleep translation threshold must not be negative.");
+	sleep_translation_threshold = p_threshold;
+	sleep_input_poses.clear();
+	sleep_targets.clear();
+	sleep_poses.clear();
+}
+
+float EWBIK3D::get_sleep_translation_threshold() const {
+	return sleep_translation_threshold;
+}
+
+void EWBIK3D::set_sleep_rotation_threshold(float p_threshold) {
+	ERR_FAIL_COND_MSG(p_threshold < 0.0f, "Sleep rotation threshold must not be negative.");
+	sleep_rotation_threshold = p_threshold;
+	sleep_input_poses.clear();
+	sleep_targets.clear();
+	sleep_poses.clear();
+}
+
+float EWBIK3D::get_sleep_rotation_threshold() const {
+	return sleep_rotation_threshold;
+}
+
+bool EWBIK3D::is_sleeping() const {
+	return sleeping;
+}
+
+int64_t EWBIK3D::get_sleeping_frame_count() const {
+	return sleeping_frame_count;
+}
+
+int64_t EWBIK3D::get_solved_frame_count() const {
+	return solved_frame_count;
+}
+
+void EWBIK3D::reset_frame_counts() {
+	sleeping_frame_count = 0;
+	solved_frame_count = 0;
+}
+
+void EWBIK3D::set_root_bone(const StringName &p_bone) {
+	root_bone = p_bone;
+	set_dirty();
+}
+
+StringName EWBIK3D::get_root_bone() const {
+	return root_bone;
+}
+
+void EWBIK3D::set_tip_bone(const StringName &p_bone) {
+	tip_bone = p_bone;
+	set_dirty();
+}
+
+StringName EWBIK3D::get_tip_bone() const {
+	return tip_bone;
+}
+
+bool EWBIK3D::is_bone_in_scope(BoneId p_bone) const {
+	return p_bone >= 0 && uint32_t(p_bone) < bone_scope.size() && (bone_scope[p_bone] & BONE_SCOPE_BUILT);
+}
+
+bool EWBIK3D::is_bone_pin_root(BoneId p_bone) const {
+	return p_bone >= 0 && uint32_t(p_bone) < bone_scope.size() && (bone_scope[p_bone] & BONE_SCOPE_PIN_ROOT);
+}
+
+void EWBIK3D::_update_bone_scope(Skeleton3D *p_skeleton, const Vector<Ref<IKEffectorTemplate3D>> &p_pins, Vector<BoneId> &r_roots) {
+	r_roots.clear();
+	const int32_t skeleton_bone_count = p_skeleton->get_bone_count();
+	bone_scope.resize(skeleton_bone_count);
+	for (int32_t bone_i = 0; bone_i < skeleton_bone_count; bone_i++) {
+		bone_scope[bone_i] = 0;
+	}
+	BoneId scope_root = -1;
+	if (root_bone != StringName()) {
+		scope_root = p_skeleton->find_bone(root_bone);
+		ERR_FAIL_COND_MSG(scope_root == -1, vformat("EWBIK3D root bone \"%s\" is not in the skeleton.", root_bone));
+		bone_scope[scope_root] |= BONE_SCOPE_BUILT;
+	} else {
+		// Every skeleton root keeps a segment, pinned or not, as before scoping existed.
+		for (BoneId parentless_bone : p_skeleton->get_parentless_bones()) {
+			bone_scope[parentless_bone] |= BONE_SCOPE_BUILT;
+		}
+	}
+	const BoneId scope_tip = tip_bone == StringName() ? BoneId(-1) : p_skeleton->find_bone(tip_bone);
+	if (tip_bone != StringName() && scope_tip == -1) {
+		ERR_PRINT(vformat("EWBIK3D tip bone \"%s\" is not in the skeleton.", tip_bone));
+	}
+	// Only the bones between a pin and where it stops are built: its own root bone, the solver's root bone, or a parentless bone.
+	for (const Ref<IKEffectorTemplate3D> &pin : p_pins) {
+		if (pin.is_null()) {
+			continue;
+		}
+		const BoneId pin_bone = p_skeleton->find_bone(pin->get_name());
+		if (pin_bone == -1) {
+			continue;
+		}
+		const BoneId pin_root = pin->get_root_bone().is_empty() ? BoneId(-1) : p_skeleton->find_bone(pin->get_root_bone());
+		bool in_scope = scope_root == -1;
+		bool past_tip = false;
+		bool reaches_pin_root = false;
+		for (BoneId bone = pin_bone; bone != -1; bone = p_skeleton->get_bone_parent(bone)) {
+			past_tip = past_tip || (bone == scope_tip && bone != pin_bone);
+			reaches_pin_root = reaches_pin_root || bone == pin_root;
+			if (bone == scope_root) {
+				in_scope = true;
+				break;
+			}
+		}
+		if (!in_scope || past_tip) {
+			continue;
+		}
+		if (!pin->get_root_bone().is_empty() && !reaches_pin_root) {
+			// A root bone above the solver's root bone is clamped to it; one off the pin's chain is ignored.
+			bool above_scope_root = false;
+			for (BoneId bone = scope_root; bone != -1 && !above_scope_root; bone = p_skeleton->get_bone_parent(bone)) {
+				above_scope_root = bone == pin_root;
+			}
+			if (!above_scope_root) {
+				WARN_PRINT(vformat("EWBIK3D pin root bone \"%s\" is not an ancestor of \"%s\", so it is ignored.", pin->get_root_bone(), pin->get_name()));
+			}
+		}
+		const BoneId stop_bone = reaches_pin_root ? pin_root : scope_root;
+		for (BoneId bone = pin_bone; bone != -1; bone = p_skeleton->get_bone_parent(bone)) {
+			bone_scope[bone] |= BONE_SCOPE_BUILT;
+			if (bone == stop_bone) {
+				break;
+			}
+		}
+		if (reaches_pin_root) {
+			bone_scope[pin_root] |= BONE_SCOPE_PIN_ROOT;
+		}
+	}
+	// A built bone whose parent is not built roots its own segmented skeleton.
+	for (BoneId bone_i = 0; bone_i < skeleton_bone_count; bone_i++) {
+		if (!(bone_scope[bone_i] & BONE_SCOPE_BUILT)) {
+			continue;
+		}
+		const BoneId parent = p_skeleton->get_bone_parent(bone_i);
+		if (parent == -1 || bone_i == scope_root || !(bone_scope[parent] & BONE_SCOPE_BUILT)) {
+			r_roots.push_back(bone_i);
+		}
+	}
+}
+
+void EWBIK3D::set_partial_solve(bool p_enabled) {
+	partial_solve = p_enabled;
+}
+
+bool EWBIK3D::get_partial_solve() const {
+	return partial_solve;
+}
+
+int32_t EWBIK3D::get_last_solved_segment_count() const {
+	return last_solved_segment_count;
+}
+
+const IKPoseSnapshot3D &EWBIK3D::get_pose_snapshot() const {
+	return pose_snapshot;
+}
+
+PackedFloat32Array EWBIK3D::get_solved_pose() const {
+	LocalVector<Transform3D> transforms;
+	PackedFloat32Array pose;
+	if (!pose_snapshot.read(transforms)) {
+		return pose;
+	}
+	pose.resize(transforms.size() * 12);
+	float *w = pose.ptrw();
+	for (const Transform3D &transform : transforms) {
+		for (int32_t row = 0; row < 3; row++) {
+			*w++ = transform.basis.rows[row].x;
+			*w++ = transform.basis.rows[row].y;
+			*w++ = transform.basis.rows[row].z;
+			*w++ = transform.origin[row];
+		}
+	}
+	return pose;
+}
+
+int64_t EWBIK3D::get_solved_pose_version() const {
+	return pose_snapshot.get_version();
+}
+
 Transform3D EWBIK3D::get_godot_skeleton_transform_inverse() {
 	return godot_skeleton_transform_inverse;
 }
@@ -1018,24 +2272,90 @@ int32_t EWBIK3D::find_pin(String p_string) const {
 	return -1;
 }
 
+void EWBIK3D::_update_unscoped_bones(Skeleton3D *p_skeleton) {
+	const int32_t skeleton_bone_count = p_skeleton->get_bone_count();
+	LocalVector<uint8_t> built;
+	built.resize(skeleton_bone_count);
+	for (int32_t bone_i = 0; bone_i < skeleton_bone_count; bone_i++) {
+		built[bone_i] = 0;
+	}
+	for (const Ref<IKBone3D> &bone : bone_list) {
+		if (bone.is_valid() && bone->get_bone_id() >= 0 && bone->get_bone_id() < skeleton_bone_count) {
+			built[bone->get_bone_id()] = 1;
+		}
+	}
+	// Walk the hierarchy from the top, so every bone comes after its parent.
+	unscoped_bones.clear();
+	unscoped_bone_parents.clear();
+	LocalVector<BoneId> pending;
+	for (BoneId parentless_bone : p_skeleton->get_parentless_bones()) {
+		pending.push_back(parentless_bone);
+	}
+	for (uint32_t pending_i = 0; pending_i < pending.size(); pending_i++) {
+		const BoneId bone = pending[pending_i];
+		if (!built[bone]) {
+			unscoped_bones.push_back(bone);
+			unscoped_bone_parents.push_back(p_skeleton->get_bone_parent(bone));
+		}
+		for (int child : p_skeleton->get_bone_children(bone)) {
+			pending.push_back(child);
+		}
+	}
+	unscoped_bone_poses.resize(unscoped_bones.size());
+}
+
 void EWBIK3D::_bone_list_changed() {
+	_finish_async_solve(true);
+	// Both pose buffers follow the old bone order.
+	async_poses[0].clear();
+	async_poses[1].clear();
+	tick_poses_valid = false;
+	tick_target_origins.clear();
+	solve_time = 0.0;
+	sleep_input_poses.clear();
+	sleep_targets.clear();
+	sleep_poses.clear();
+	moved_pins.clear();
+	bone_pose_write_thresholds_dirty = true;
 	Skeleton3D *skeleton = get_skeleton();
-	Vector<int32_t> roots = skeleton->get_parentless_bones();
+	pose_snapshot.resize(skeleton->get_bone_count());
+	Vector<BoneId> roots;
+	_update_bone_scope(skeleton, pins, roots);
 	if (roots.is_empty()) {
+		bone_list.clear();
+		segmented_skeletons.clear();
+		segment_root_parents.clear();
+		pin_effectors.clear();
+		_update_unscoped_bones(skeleton);
 		return;
 	}
 	bone_list.clear();
 	segmented_skeletons.clear();
+	segment_root_parents.clear();
 
 	// Create ik_origin once outside the loop
 	if (ik_origin.is_null()) {
 		ik_origin.instantiate();
 	}
-
+	lod_radius = CMP_EPSILON;
+	for (BoneId bone_i = 0; bone_i < skeleton->get_bone_count(); bone_i++) {
+		if (is_bone_in_scope(bone_i)) {
+			lod_radius = MAX(lod_radius, skeleton->get_bone_global_rest(bone_i).origin.length());
+		}
+	}
 	for (BoneId root_bone_index : roots) {
-		String parentless_bone = skeleton->get_bone_name(root_bone_index);
-		Ref<IKBoneSegment3D> segmented_skeleton = Ref<IKBoneSegment3D>(memnew(IKBoneSegment3D(skeleton, parentless_bone, pins, this, nullptr, root_bone_index, -1, stabilize_passes)));
-		segmented_skeleton->get_root()->get_ik_transform()->set_parent(ik_origin);
+		String segment_root_bone = skeleton->get_bone_name(root_bone_index);
+		Ref<IKBoneSegment3D> segmented_skeleton = Ref<IKBoneSegment3D>(memnew(IKBoneSegment3D(skeleton, segment_root_bone, pins, this, nullptr, root_bone_index, -1, stabilize_passes)));
+		// A root below the top of the skeleton hangs from its parent bone's pose, which is not built.
+		Ref<IKNode3D> root_parent;
+		if (skeleton->get_bone_parent(root_bone_index) != -1) {
+			root_parent.instantiate();
+			root_parent->set_parent(ik_origin);
+			segmented_skeleton->get_root()->get_ik_transform()->set_parent(root_parent);
+		} else {
+			segmented_skeleton->get_root()->get_ik_transform()->set_parent(ik_origin);
+		}
+		segment_root_parents.push_back(root_parent);
 		segmented_skeleton->generate_default_segments(pins, root_bone_index, -1, this);
 		Vector<Ref<IKBone3D>> new_bone_list;
 		segmented_skeleton->create_bone_list(new_bone_list, true);
@@ -1045,6 +2365,25 @@ void EWBIK3D::_bone_list_changed() {
 		segmented_skeleton->recursive_create_headings_arrays_for(segmented_skeleton);
 		segmented_skeletons.push_back(segmented_skeleton);
 	}
+	pin_effectors.clear();
+	pin_effectors.resize(pins.size());
+	for (const Ref<IKBone3D> &ik_bone_3d : bone_list) {
+		if (ik_bone_3d->is_pinned()) {
+			const int32_t pin_i = find_pin(ik_bone_3d->get_name());
+			if (pin_i != -1) {
+				pin_effectors.write[pin_i] = ik_bone_3d->get_pin();
+			}
+		}
+	}
+	// New effectors start out moved, so the first solve after a rebuild runs every segment.
+	for (int32_t pin_i = 0; pin_i < pin_effectors.size(); pin_i++) {
+		if (pin_effectors[pin_i].is_valid()) {
+			moved_pins.push_back(pin_i);
+		}
+	}
+	// The rebuild waited for any running solve, so the tier applies to the new effectors right away.
+	_apply_lod_to_segments();
+	_update_unscoped_bones(skeleton);
 	_update_ik_bones_transform();
 	for (Ref<IKBone3D> &ik_bone_3d : bone_list) {
 		ik_bone_3d->update_default_bone_direction_transform(skeleton);
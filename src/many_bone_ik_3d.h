@@ -34,8 +34,15 @@
 #include "core/math/transform_3d.h"
 #include "core/math/vector3.h"
 #include "core/object/ref_counted.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/variant/dictionary.h"
 #include "ik_bone_3d.h"
 #include "ik_effector_template_3d.h"
+#include "ik_pin_target_queue_3d.h"
+#include "ik_pose_snapshot_3d.h"
+#include "ik_solve_scheduler_3d.h"
 #include "math/ik_node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/3d/skeleton_modifier_3d.h"
@@ -44,13 +51,35 @@ class ManyBoneIK3DState;
 class EWBIK3D : public SkeletonModifier3D {
 	GDCLASS(EWBIK3D, SkeletonModifier3D);
 
+public:
+	enum SolverBackend {
+		SOLVER_BACKEND_QCP,
+		SOLVER_BACKEND_FABRIK,
+		SOLVER_BACKEND_DAMPED_LEAST_SQUARES,
+	};
+	enum BoneUpdateMode {
+		BONE_UPDATE_GAUSS_SEIDEL,
+		BONE_UPDATE_JACOBI,
+	};
+	enum PinTargetSpace {
+		PIN_TARGET_SPACE_SKELETON,
+		PIN_TARGET_SPACE_WORLD,
+	};
+	enum LODMetric {
+		LOD_METRIC_DISTANCE,
+		LOD_METRIC_SCREEN_SIZE,
+	};
+
+private:
 	bool is_constraint_mode = false;
 	NodePath skeleton_path;
 	Vector<Ref<IKBoneSegment3D>> segmented_skeletons;
 	int32_t constraint_count = 0, pin_count = 0, bone_count = 0;
 	Vector<StringName> constraint_names;
 	Vector<Ref<IKEffectorTemplate3D>> pins;
+	Vector<Ref<IKEffector3D>> pin_effectors; // Live effector of each pin, rebuilt with the segments.
 	Vector<Ref<IKBone3D>> bone_list;
+	LocalVector<Transform3D> bone_poses; // Local poses in bone_list order, staged between the skeleton and the IK nodes.
 	Vector<Vector2> joint_twist;
 	Vector<float> bone_damp;
 	Vector<Vector<Vector4>> kusudama_open_cones;
@@ -64,20 +93,106 @@ class EWBIK3D : public SkeletonModifier3D {
 	bool is_dirty = true;
 	NodePath skeleton_node_path = NodePath("..");
 	int32_t ui_selected_bone = -1, stabilize_passes = 0;
+	bool two_bone_fast_path = true;
+	SolverBackend solver_backend = SOLVER_BACKEND_QCP;
+	Dictionary segment_solver_backends; // Segment root bone name to SolverBackend.
+	BoneUpdateMode bone_update_mode = BONE_UPDATE_GAUSS_SEIDEL;
+	float jacobi_relaxation = 1.0f;
+	float pose_write_translation_epsilon = 0.0f;
+	float pose_write_rotation_epsilon = 0.0f;
+	int32_t pose_write_bone_count = 0;
+	Vector<StringName> pose_write_bone_names;
+	Vector<Vector2> pose_write_bone_epsilons; // Translation and rotation; a negative one falls back to the modifier's.
+	// Per bone_list entry: the squared translation epsilon, negative to always write, and the cosine of half the rotation epsilon.
+	LocalVector<Vector2> bone_pose_write_thresholds;
+	bool bone_pose_write_thresholds_dirty = true;
+	int32_t last_written_bone_count = 0;
+	static constexpr int32_t PIN_TARGET_HISTORY_SIZE = 4;
+	IKPinTargetQueue3D pin_target_queue;
+	LocalVector<IKPinTargetSample3D> pin_target_drain; // Scratch for one pop of the whole queue.
+	LocalVector<IKPinTargetSample3D> pin_target_history; // The newest PIN_TARGET_HISTORY_SIZE samples of each pin, oldest first.
+	LocalVector<uint8_t> pin_target_history_count;
+	LocalVector<uint8_t> pin_target_received; // Pins that got a sample since the last solve.
+	float pin_target_interpolation_delay = 0.0f;
+	bool async_solve = false;
+	WorkerThreadPool::TaskID async_solve_task = WorkerThreadPool::INVALID_TASK_ID;
+	SafeFlag async_solve_cancelled;
+	LocalVector<Transform3D> async_poses[2]; // The worker fills the back buffer while the front one is applied.
+	uint32_t async_front_poses = 0;
+	IKPoseSnapshot3D pose_snapshot; // Indexed by bone id.
+	float solve_rate = 0.0f;
+	float fast_target_speed = 0.0f;
+	double solve_time = 0.0; // Since the last solve at solve_rate.
+	LocalVector<Transform3D> tick_poses[2]; // The two newest solves, interpolated between on the frames that do not solve.
+	uint32_t tick_current = 0;
+	bool tick_poses_valid = false;
+	LocalVector<Vector3> tick_target_origins; // Pin target origins at the last solve, for fast_target_speed.
+	Ref<IKSolveScheduler3D> solve_scheduler;
+	StringName root_bone; // Empty builds from every parentless bone.
+	StringName tip_bone;
+	enum {
+		BONE_SCOPE_BUILT = 1 << 0, // On the path from a scope root down to a pin in scope.
+		BONE_SCOPE_PIN_ROOT = 1 << 1, // The root bone of a pin, which always starts a segment.
+	};
+	LocalVector<uint8_t> bone_scope; // Indexed by bone id.
+	// Skeleton bones left out of bone_list, parents first, so the pose snapshot can still report them.
+	LocalVector<BoneId> unscoped_bones;
+	LocalVector<BoneId> unscoped_bone_parents;
+	LocalVector<Transform3D> unscoped_bone_poses; // Their incoming local poses, read with the built bones' poses.
+	Vector<Ref<IKNode3D>> segment_root_parents; // Skeleton-space pose of each segmented skeleton root's parent bone, if it has one.
+	LODMetric lod_metric = LOD_METRIC_DISTANCE;
+	PackedFloat32Array lod_thresholds; // Where each coarser tier starts: growing distances, or shrinking screen sizes.
+	float lod_hysteresis = 0.1f;
+	float lod_min_pin_weight = 0.5f;
+	int32_t lod_freeze_depth = 2;
+	int32_t lod_tier = 0;
+	real_t lod_radius = 1.0; // Reach of the rest pose from the skeleton origin, for the projected screen size.
+	bool lod_apply_pending = false; // The tier changed while the async worker owned the segments.
+	float sleep_translation_threshold = 0.0f;
+	float sleep_rotation_threshold = 0.0f;
+	LocalVector<Transform3D> sleep_input_poses; // The skeleton's pose when the last solve started, in bone_list order.
+	LocalVector<Transform3D> sleep_targets; // The pin targets of the last solve.
+	LocalVector<Transform3D> sleep_poses; // The last solved pose, applied again while asleep.
+	bool sleeping = false;
+	uint64_t sleeping_frame_count = 0;
+	uint64_t solved_frame_count = 0;
+	bool partial_solve = false;
+	LocalVector<int32_t> moved_pins; // The pins whose target moved since the last solve, each listed once.
+	Transform3D target_skeleton_transform; // The skeleton's global transform when the node targets were last read.
+	int32_t last_solved_segment_count = 0;
 
 	void _on_timer_timeout();
 	void _update_ik_bones_transform();
 	void _update_skeleton_bones_transform();
+	void _gather_bone_poses(LocalVector<Transform3D> &r_poses) const;
+	void _write_bone_poses(const LocalVector<Transform3D> &p_poses);
+	void _update_bone_pose_write_thresholds();
+	void _publish_bone_poses(const LocalVector<Transform3D> &p_poses);
+	void _solve(int32_t p_iterations);
+	void _solve_async(int32_t p_iterations);
+	void _launch_async_solve();
+	void _finish_async_solve(bool p_cancel = false);
+	bool _consume_solve_tick(bool &r_fast);
+	void _solve_tick(bool p_solve, bool p_fast);
+	int32_t _get_solve_iterations() const;
+	bool _is_sleep_enabled() const;
+	bool _is_solve_input_unchanged();
+	void _prepare_segment_solve();
+	void _mark_pin_moved(int32_t p_pin_index);
+	void _update_lod_tier();
+	void _set_lod_tier(int32_t p_tier);
+	void _apply_lod_to_segments();
 	Vector<Ref<IKEffectorTemplate3D>> _get_bone_effectors() const;
-	void set_constraint_name_at_index(int32_t p_index, String p_name);
 	void _set_constraint_count(int32_t p_count);
 	void _remove_pin(int32_t p_index);
 	void _set_bone_count(int32_t p_count);
-	void _set_pin_root_bone(int32_t p_pin_index, const String &p_root_bone);
-	String _get_pin_root_bone(int32_t p_pin_index) const;
+	void _update_bone_scope(Skeleton3D *p_skeleton, const Vector<Ref<IKEffectorTemplate3D>> &p_pins, Vector<BoneId> &r_roots);
+	void _update_unscoped_bones(Skeleton3D *p_skeleton);
 	void _bone_list_changed();
 	void _pose_updated();
 	void _update_ik_bone_pose(int32_t p_bone_idx);
+	void _set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform, bool p_world);
+	void _drain_pin_target_queue();
 
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
@@ -91,8 +206,75 @@ public:
 	void set_state(Ref<ManyBoneIK3DState> p_state);
 	Ref<ManyBoneIK3DState> get_state() const;
 	void add_constraint();
+	void set_constraint_name_at_index(int32_t p_index, String p_name);
 	void set_stabilization_passes(int32_t p_passes);
 	int32_t get_stabilization_passes();
+	void set_two_bone_fast_path(bool p_enabled);
+	bool get_two_bone_fast_path() const;
+	void set_solver_backend(SolverBackend p_backend);
+	SolverBackend get_solver_backend() const;
+	void set_segment_solver_backend(const StringName &p_root_bone, SolverBackend p_backend);
+	void clear_segment_solver_backend(const StringName &p_root_bone);
+	SolverBackend get_segment_solver_backend(const StringName &p_root_bone) const;
+	void set_segment_solver_backends(const Dictionary &p_backends);
+	Dictionary get_segment_solver_backends() const;
+	void set_bone_update_mode(BoneUpdateMode p_mode);
+	BoneUpdateMode get_bone_update_mode() const;
+	void set_jacobi_relaxation(float p_relaxation);
+	float get_jacobi_relaxation() const;
+	void set_pose_write_translation_epsilon(float p_epsilon);
+	float get_pose_write_translation_epsilon() const;
+	void set_pose_write_rotation_epsilon(float p_epsilon);
+	float get_pose_write_rotation_epsilon() const;
+	void set_pose_write_bone_count(int32_t p_count);
+	int32_t get_pose_write_bone_count() const;
+	void set_pose_write_bone_name(int32_t p_index, const StringName &p_bone_name);
+	StringName get_pose_write_bone_name(int32_t p_index) const;
+	void set_pose_write_bone_translation_epsilon(int32_t p_index, float p_epsilon);
+	float get_pose_write_bone_translation_epsilon(int32_t p_index) const;
+	void set_pose_write_bone_rotation_epsilon(int32_t p_index, float p_epsilon);
+	float get_pose_write_bone_rotation_epsilon(int32_t p_index) const;
+	int32_t get_last_written_bone_count() const;
+	void set_async_solve(bool p_enabled);
+	bool get_async_solve() const;
+	bool is_async_solve_running() const;
+	void set_solve_rate(float p_rate);
+	float get_solve_rate() const;
+	void set_fast_target_speed(float p_speed);
+	float get_fast_target_speed() const;
+	void set_solve_scheduler(const Ref<IKSolveScheduler3D> &p_scheduler);
+	Ref<IKSolveScheduler3D> get_solve_scheduler() const;
+	void set_lod_metric(LODMetric p_metric);
+	LODMetric get_lod_metric() const;
+	void set_lod_thresholds(const PackedFloat32Array &p_thresholds);
+	PackedFloat32Array get_lod_thresholds() const;
+	void set_lod_hysteresis(float p_hysteresis);
+	float get_lod_hysteresis() const;
+	void set_lod_min_pin_weight(float p_weight);
+	float get_lod_min_pin_weight() const;
+	void set_lod_freeze_depth(int32_t p_depth);
+	int32_t get_lod_freeze_depth() const;
+	int32_t get_lod_tier() const;
+	void set_sleep_translation_threshold(float p_threshold);
+	float get_sleep_translation_threshold() const;
+	void set_sleep_rotation_threshold(float p_threshold);
+	float get_sleep_rotation_threshold() const;
+	bool is_sleeping() const;
+	int64_t get_sleeping_frame_count() const;
+	int64_t get_solved_frame_count() const;
+	void reset_frame_counts();
+	void set_root_bone(const StringName &p_bone);
+	StringName get_root_bone() const;
+	void set_tip_bone(const StringName &p_bone);
+	StringName get_tip_bone() const;
+	bool is_bone_in_scope(BoneId p_bone) const;
+	bool is_bone_pin_root(BoneId p_bone) const;
+	void set_partial_solve(bool p_enabled);
+	bool get_partial_solve() const;
+	int32_t get_last_solved_segment_count() const;
+	const IKPoseSnapshot3D &get_pose_snapshot() const;
+	PackedFloat32Array get_solved_pose() const;
+	int64_t get_solved_pose_version() const;
 	Transform3D get_godot_skeleton_transform_inverse();
 	Ref<IKNode3D> get_godot_skeleton_transform();
 	void set_ui_selected_bone(int32_t p_ui_selected_bone);
@@ -123,6 +305,18 @@ public:
 	NodePath get_pin_target_node_path(int32_t p_pin_index);
 	void set_pin_motion_propagation_factor(int32_t p_effector_index, const float p_motion_propagation_factor);
 	float get_pin_motion_propagation_factor(int32_t p_effector_index) const;
+	void set_pin_root_bone(int32_t p_pin_index, const StringName &p_root_bone);
+	StringName get_pin_root_bone(int32_t p_pin_index) const;
+	void set_pin_target_transform(int32_t p_pin_index, const Transform3D &p_transform, PinTargetSpace p_space = PIN_TARGET_SPACE_SKELETON);
+	void set_pin_target_transforms(const PackedFloat32Array &p_transforms, PinTargetSpace p_space = PIN_TARGET_SPACE_SKELETON);
+	Transform3D get_pin_target_transform(int32_t p_pin_index) const;
+	void clear_pin_target_transform(int32_t p_pin_index);
+	bool is_pin_target_transform_enabled(int32_t p_pin_index) const;
+	bool push_pin_target(int32_t p_pin_index, const Transform3D &p_transform, double p_timestamp, PinTargetSpace p_space = PIN_TARGET_SPACE_SKELETON);
+	void set_pin_target_queue_capacity(int32_t p_capacity);
+	int32_t get_pin_target_queue_capacity() const;
+	void set_pin_target_interpolation_delay(float p_delay);
+	float get_pin_target_interpolation_delay() const;
 	real_t get_default_damp() const;
 	void set_default_damp(float p_default_damp);
 	int32_t find_constraint(String p_string) const;
@@ -153,3 +347,8 @@ public:
 	~EWBIK3D();
 	void set_dirty();
 };
+
+VARIANT_ENUM_CAST(EWBIK3D::SolverBackend);
+VARIANT_ENUM_CAST(EWBIK3D::BoneUpdateMode);
+VARIANT_ENUM_CAST(EWBIK3D::PinTargetSpace);
+VARIANT_ENUM_CAST(EWBIK3D::LODMetric);
@@ -31,18 +31,16 @@
 #include "ik_node_3d.h"
 
 void IKNode3D::_propagate_transform_changed() {
-	Vector<Ref<IKNode3D>> to_remove;
-
-	for (Ref<IKNode3D> transform : children) {
-		if (transform.is_null()) {
-			to_remove.push_back(transform);
+	// Runs on every pose change, so released children are unlinked in place rather than collected.
+	List<Ref<IKNode3D>>::Element *E = children.front();
+	while (E) {
+		List<Ref<IKNode3D>>::Element *next = E->next();
+		if (E->get().is_null()) {
+			children.erase(E);
 		} else {
-			transform->_propagate_transform_changed();
+			E->get()->_propagate_transform_changed();
 		}
-	}
-
-	for (Ref<IKNode3D> transform : to_remove) {
-		children.erase(transform);
+		E = next;
 	}
 
 	dirty |= DIRTY_GLOBAL;
@@ -66,11 +64,13 @@ void IKNode3D::rotate_local_with_global(const Basis &p_basis, bool p_propagate)
 	}
 }
 
-void IKNode3D::set_transform(const Transform3D &p_transform) {
+void IKNode3D::set_transform(const Transform3D &p_transform, bool p_propagate) {
 	if (local_transform != p_transform) {
 		local_transform = p_transform;
 		dirty |= DIRTY_VECTORS;
-		_propagate_transform_changed();
+		if (p_propagate) {
+			_propagate_transform_changed();
+		}
 	}
 }
 
@@ -66,7 +66,7 @@ protected:
 		ClassDB::bind_method(D_METHOD("_propagate_transform_changed"), &IKNode3D::_propagate_transform_changed);
 		ClassDB::bind_method(D_METHOD("_update_local_transform"), &IKNode3D::_update_local_transform);
 		ClassDB::bind_method(D_METHOD("rotate_local_with_global", "p_basis", "p_propagate"), &IKNode3D::rotate_local_with_global, DEFVAL(false));
-		ClassDB::bind_method(D_METHOD("set_transform", "p_transform"), &IKNode3D::set_transform);
+		ClassDB::bind_method(D_METHOD("set_transform", "p_transform", "p_propagate"), &IKNode3D::set_transform, DEFVAL(true));
 		ClassDB::bind_method(D_METHOD("set_global_transform", "p_transform"), &IKNode3D::set_global_transform);
 		ClassDB::bind_method(D_METHOD("get_transform"), &IKNode3D::get_transform);
 		ClassDB::bind_method(D_METHOD("get_global_transform"), &IKNode3D::get_global_transform);
@@ -80,7 +80,9 @@ protected:
 
 public:
 	void _propagate_transform_changed();
-	void set_transform(const Transform3D &p_transform);
+	// Without propagation the children keep stale globals until _propagate_transform_changed() runs on an ancestor;
+	// bulk writers use this to touch every node once.
+	void set_transform(const Transform3D &p_transform, bool p_propagate = true);
 	void set_global_transform(const Transform3D &p_transform);
 	Transform3D get_transform() const;
 	Transform3D get_global_transform() const;
@@ -30,6 +30,8 @@
 
 #include "qcp.h"
 
+#include <cmath>
+
 QuaternionCharacteristicPolynomial::QuaternionCharacteristicPolynomial(double p_evec_prec) {
 	eigenvector_precision = p_evec_prec;
 }
@@ -173,6 +175,8 @@ Quaternion QuaternionCharacteristicPolynomial::apply_canonical_form(const Quater
 void QuaternionCharacteristicPolynomial::set(PackedVector3Array &r_target, PackedVector3Array &r_moved) {
 	target = r_target;
 	moved = r_moved;
+	moved_center = Vector3();
+	target_center = Vector3();
 	transformation_calculated = false;
 	inner_product_calculated = false;
 }
@@ -182,7 +186,7 @@ Quaternion QuaternionCharacteristicPolynomial::_get_rotation() {
 		if (!inner_product_calculated) {
 			inner_product(moved, target);
 		}
-		rotation = calculate_rotation();
+		rotation = calculate_rotation(method);
 		transformation_calculated = true;
 	}
 	return rotation;
@@ -290,6 +294,254 @@ Quaternion QuaternionCharacteristicPolynomial::calculate_rotation() {
 	return apply_canonical_form(result);
 }
 
+void QuaternionCharacteristicPolynomial::calculate_characteristic_polynomial(double &r_c2, double &r_c1, double &r_c0) const {
+	// The key matrix is traceless, so its characteristic polynomial is x^4 + c2 x^2 + c1 x + c0, from Theobald's QCP.
+	double sum_xx2 = sum_xx * sum_xx, sum_yy2 = sum_yy * sum_yy, sum_zz2 = sum_zz * sum_zz;
+	double sum_xy2 = sum_xy * sum_xy, sum_yz2 = sum_yz * sum_yz, sum_xz2 = sum_xz * sum_xz;
+	double sum_yx2 = sum_yx * sum_yx, sum_zy2 = sum_zy * sum_zy, sum_zx2 = sum_zx * sum_zx;
+	double syz_szy_m_syy_szz2 = 2.0 * (sum_yz * sum_zy - sum_yy * sum_zz);
+	double sxx2_syy2_szz2_syz2_szy2 = sum_yy2 + sum_zz2 - sum_xx2 + sum_yz2 + sum_zy2;
+	double sxy2_sxz2_syx2_szx2 = sum_yx2 + sum_zx2 - sum_xy2 - sum_xz2;
+
+	r_c2 = -2.0 * (sum_xx2 + sum_yy2 + sum_zz2 + sum_xy2 + sum_yx2 + sum_xz2 + sum_zx2 + sum_yz2 + sum_zy2);
+	r_c1 = 8.0 * (sum_xx * sum_yz * sum_zy + sum_yy * sum_zx * sum_xz + sum_zz * sum_xy * sum_yx - sum_xx * sum_yy * sum_zz - sum_yz * sum_zx * sum_xy - sum_zy * sum_yx * sum_xz);
+	r_c0 = sxy2_sxz2_syx2_szx2 * sxy2_sxz2_syx2_szx2 +
+			(sxx2_syy2_szz2_syz2_szy2 + syz_szy_m_syy_szz2) * (sxx2_syy2_szz2_syz2_szy2 - syz_szy_m_syy_szz2) +
+			(-sum_xz_plus_zx * sum_yz_minus_zy + sum_xy_minus_yx * (sum_xx_minus_yy - sum_zz)) * (-sum_xz_minus_zx * sum_yz_plus_zy + sum_xy_minus_yx * (sum_xx_minus_yy + sum_zz)) +
+			(-sum_xz_plus_zx * sum_yz_plus_zy - sum_xy_plus_yx * (sum_xx_plus_yy - sum_zz)) * (-sum_xz_minus_zx * sum_yz_minus_zy - sum_xy_plus_yx * (sum_xx_plus_yy + sum_zz)) +
+			(sum_xy_plus_yx * sum_yz_plus_zy + sum_xz_plus_zx * (sum_xx_minus_yy + sum_zz)) * (-sum_xy_minus_yx * sum_yz_minus_zy + sum_xz_plus_zx * (sum_xx_plus_yy + sum_zz)) +
+			(sum_xy_plus_yx * sum_yz_minus_zy + sum_xz_minus_zx * (sum_xx_minus_yy - sum_zz)) * (-sum_xy_minus_yx * sum_yz_plus_zy + sum_xz_minus_zx * (sum_xx_plus_yy - sum_zz));
+}
+
+double QuaternionCharacteristicPolynomial::calculate_max_eigenvalue() const {
+	// Newton-Raphson on the characteristic polynomial of the key matrix.
+	// The rotation keeps using the upper bound held in max_eigenvalue; the exact value only sets the residual.
+	double c2, c1, c0;
+	calculate_characteristic_polynomial(c2, c1, c0);
+
+	// The initial eigenvalue bounds the largest root from above, so Newton's method descends onto it.
+	double eigenvalue = squared_norm_sum * 0.5;
+	for (int i = 0; i < 50; i++) {
+		double previous = eigenvalue;
+		double x2 = eigenvalue * eigenvalue;
+		double b = (x2 + c2) * eigenvalue;
+		double a = b + c1;
+		double derivative = 2.0 * x2 * eigenvalue + b + a;
+		if (derivative == 0.0) {
+			break;
+		}
+		eigenvalue -= (a * eigenvalue + c0) / derivative;
+		if (Math::abs(eigenvalue - previous) < Math::abs(1e-11 * eigenvalue)) {
+			break;
+		}
+	}
+	return eigenvalue;
+}
+
+Quaternion QuaternionCharacteristicPolynomial::calculate_rotation(SuperpositionMethod p_method) {
+	switch (p_method) {
+		case METHOD_HORN:
+			return calculate_rotation_horn();
+		case METHOD_KABSCH:
+			return calculate_rotation_kabsch();
+		default:
+			return calculate_rotation();
+	}
+}
+
+Quaternion QuaternionCharacteristicPolynomial::calculate_rotation_horn() const {
+	// Ferrari: x^4 + p x^2 + q x + r splits into two quadratics once a root m of its resolvent cubic
+	// m^3 + p m^2 + (p^2 / 4 - r) m - q^2 / 8 is known. The cubic is solved in closed form too, so the cost never varies.
+	double p, q, r;
+	calculate_characteristic_polynomial(p, q, r);
+	double cubic_b = p * p * 0.25 - r;
+	double cubic_c = -q * q * 0.125;
+	double depressed_p = cubic_b - p * p / 3.0;
+	double depressed_q = 2.0 * p * p * p / 27.0 - p * cubic_b / 3.0 + cubic_c;
+	double discriminant = depressed_q * depressed_q * 0.25 + depressed_p * depressed_p * depressed_p / 27.0;
+	double y;
+	if (discriminant > 0.0) {
+		double root = Math::sqrt(discriminant);
+		y = std::cbrt(-depressed_q * 0.5 + root) + std::cbrt(-depressed_q * 0.5 - root);
+	} else {
+		// Three real roots; the trigonometric form gives the largest directly.
+		double radius = Math::sqrt(MAX(-depressed_p * depressed_p * depressed_p / 27.0, 0.0));
+		double phi = radius > 0.0 ? Math::acos(CLAMP(-depressed_q * 0.5 / radius, -1.0, 1.0)) : 0.0;
+		y = 2.0 * Math::sqrt(MAX(-depressed_p / 3.0, 0.0)) * Math::cos(phi / 3.0);
+	}
+	double m = MAX(y - p / 3.0, 0.0);
+
+	double eigenvalue;
+	if (m < 1e-300) {
+		// q vanished and the quartic is biquadratic.
+		eigenvalue = Math::sqrt(MAX((-p + Math::sqrt(MAX(p * p - 4.0 * r, 0.0))) * 0.5, 0.0));
+	} else {
+		double s = Math::sqrt(2.0 * m);
+		double first = (s + Math::sqrt(MAX(-2.0 * m - 2.0 * p - 2.0 * q / s, 0.0))) * 0.5;
+		double second = (-s + Math::sqrt(MAX(-2.0 * m - 2.0 * p + 2.0 * q / s, 0.0))) * 0.5;
+		eigenvalue = MAX(first, second);
+	}
+	// One fixed Newton step polishes the cancellation in nearly degenerate cases.
+	double x2 = eigenvalue * eigenvalue;
+	double b = (x2 + p) * eigenvalue;
+	double a = b + q;
+	double derivative = 2.0 * x2 * eigenvalue + b + a;
+	if (derivative != 0.0) {
+		eigenvalue -= (a * eigenvalue + r) / derivative;
+	}
+
+	// The eigenvector is the largest column of the adjoint of the shifted key matrix, which is its null space.
+	double key[4][4] = {
+		{ sum_xx_plus_yy + sum_zz - eigenvalue, sum_yz_minus_zy, -sum_xz_minus_zx, sum_xy_minus_yx },
+		{ sum_yz_minus_zy, sum_xx_minus_yy - sum_zz - eigenvalue, sum_xy_plus_yx, sum_xz_plus_zx },
+		{ -sum_xz_minus_zx, sum_xy_plus_yx, sum_yy - sum_xx - sum_zz - eigenvalue, sum_yz_plus_zy },
+		{ sum_xy_minus_yx, sum_xz_plus_zx, sum_yz_plus_zy, sum_zz - sum_xx_plus_yy - eigenvalue },
+	};
+	double best[4] = { 1.0, 0.0, 0.0, 0.0 };
+	double best_length_squared = 0.0;
+	for (int column = 0; column < 4; column++) {
+		double candidate[4];
+		for (int row = 0; row < 4; row++) {
+			// Cofactor of key[column][row], which is entry (row, column) of the adjoint.
+			int rows[3], columns[3];
+			for (int i = 0, ri = 0, ci = 0; i < 4; i++) {
+				if (i != column) {
+					rows[ri++] = i;
+				}
+				if (i != row) {
+					columns[ci++] = i;
+				}
+			}
+			double minor = key[rows[0]][columns[0]] * (key[rows[1]][columns[1]] * key[rows[2]][columns[2]] - key[rows[1]][columns[2]] * key[rows[2]][columns[1]]) -
+					key[rows[0]][columns[1]] * (key[rows[1]][columns[0]] * key[rows[2]][columns[2]] - key[rows[1]][columns[2]] * key[rows[2]][columns[0]]) +
+					key[rows[0]][columns[2]] * (key[rows[1]][columns[0]] * key[rows[2]][columns[1]] - key[rows[1]][columns[1]] * key[rows[2]][columns[0]]);
+			candidate[row] = ((row + column) % 2) ? -minor : minor;
+		}
+		double length_squared = candidate[0] * candidate[0] + candidate[1] * candidate[1] + candidate[2] * candidate[2] + candidate[3] * candidate[3];
+		if (length_squared > best_length_squared) {
+			best_length_squared = length_squared;
+			for (int i = 0; i < 4; i++) {
+				best[i] = candidate[i];
+			}
+		}
+	}
+	if (best_length_squared < eigenvector_precision * eigenvector_precision || !Math::is_finite(best_length_squared)) {
+		return Quaternion();
+	}
+	double length = Math::sqrt(best_length_squared);
+	return apply_canonical_form(Quaternion(best[1] / length, best[2] / length, best[3] / length, best[0] / length));
+}
+
+Quaternion QuaternionCharacteristicPolynomial::calculate_rotation_kabsch() const {
+	// Right singular vectors of the cross-covariance H (moved by target) are the eigenvectors of H^T H.
+	const double h[3][3] = {
+		{ sum_xx, sum_xy, sum_xz },
+		{ sum_yx, sum_yy, sum_yz },
+		{ sum_zx, sum_zy, sum_zz },
+	};
+	double gram[3][3];
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 3; b++) {
+			gram[a][b] = h[0][a] * h[0][b] + h[1][a] * h[1][b] + h[2][a] * h[2][b];
+		}
+	}
+	double v[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }; // Columns are eigenvectors.
+	// Cyclic Jacobi; a 3x3 converges quadratically and this cap is never reached in practice, which bounds the cost.
+	const int MAX_SWEEPS = 12;
+	for (int sweep = 0; sweep < MAX_SWEEPS; sweep++) {
+		double off_diagonal = gram[0][1] * gram[0][1] + gram[0][2] * gram[0][2] + gram[1][2] * gram[1][2];
+		double diagonal = gram[0][0] * gram[0][0] + gram[1][1] * gram[1][1] + gram[2][2] * gram[2][2];
+		if (off_diagonal <= 1e-30 * diagonal || off_diagonal == 0.0) {
+			break;
+		}
+		for (int p = 0; p < 2; p++) {
+			for (int q = p + 1; q < 3; q++) {
+				if (gram[p][q] == 0.0) {
+					continue;
+				}
+				double theta = (gram[q][q] - gram[p][p]) / (2.0 * gram[p][q]);
+				double t = (theta >= 0.0 ? 1.0 : -1.0) / (Math::abs(theta) + Math::sqrt(theta * theta + 1.0));
+				double c = 1.0 / Math::sqrt(t * t + 1.0);
+				double s = t * c;
+				for (int k = 0; k < 3; k++) {
+					double gkp = gram[k][p], gkq = gram[k][q];
+					gram[k][p] = c * gkp - s * gkq;
+					gram[k][q] = s * gkp + c * gkq;
+				}
+				for (int k = 0; k < 3; k++) {
+					double gpk = gram[p][k], gqk = gram[q][k];
+					gram[p][k] = c * gpk - s * gqk;
+					gram[q][k] = s * gpk + c * gqk;
+				}
+				for (int k = 0; k < 3; k++) {
+					double vkp = v[k][p], vkq = v[k][q];
+					v[k][p] = c * vkp - s * vkq;
+					v[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+
+	// Order the singular directions by singular value.
+	int order[3] = { 0, 1, 2 };
+	for (int i = 0; i < 2; i++) {
+		for (int j = i + 1; j < 3; j++) {
+			if (gram[order[j]][order[j]] > gram[order[i]][order[i]]) {
+				SWAP(order[i], order[j]);
+			}
+		}
+	}
+	Vector3 v1 = Vector3(v[0][order[0]], v[1][order[0]], v[2][order[0]]);
+	Vector3 v2 = Vector3(v[0][order[1]], v[1][order[1]], v[2][order[1]]);
+	auto apply_h = [&h](const Vector3 &p_v) {
+		return Vector3(h[0][0] * p_v.x + h[0][1] * p_v.y + h[0][2] * p_v.z,
+				h[1][0] * p_v.x + h[1][1] * p_v.y + h[1][2] * p_v.z,
+				h[2][0] * p_v.x + h[2][1] * p_v.y + h[2][2] * p_v.z);
+	};
+	// Left singular vectors follow from H v = sigma u. Completing both frames with cross products keeps them proper rotations,
+	// which folds the reflection case of Kabsch into the sign of the smallest singular value.
+	Vector3 u1 = apply_h(v1);
+	if (u1.length_squared() < eigenvector_precision * eigenvector_precision) {
+		return Quaternion();
+	}
+	u1.normalize();
+	Vector3 u2 = apply_h(v2);
+	u2 -= u1 * u1.dot(u2);
+	if (u2.length_squared() < CMP_EPSILON2) {
+		// Rank one: every rotation taking u1 onto v1 is optimal; pick any perpendicular pair.
+		auto any_perpendicular = [](const Vector3 &p_v) {
+			Vector3 axis = Vector3(0, 0, 0);
+			axis[p_v.abs().min_axis_index()] = 1;
+			return p_v.cross(axis);
+		};
+		u2 = any_perpendicular(u1);
+		v2 = any_perpendicular(v1);
+	}
+	u2.normalize();
+	v2 = (v2 - v1 * v1.dot(v2)).normalized();
+	Basis left = Basis(u1, u2, u1.cross(u2)); // Columns u1, u2, u3.
+	Basis right = Basis(v1, v2, v1.cross(v2));
+	// R takes each u onto its v.
+	return apply_canonical_form((right * left.transposed()).get_rotation_quaternion());
+}
+
+double QuaternionCharacteristicPolynomial::Superposition::get_msd(const Quaternion &p_rotation, const Vector3 &p_translation) const {
+	if (weight_sum <= 0.0) {
+		return 0.0;
+	}
+	// sum(w * |R m + t - g|^2) expands to the stored sums, so no point is visited again.
+	Basis rotation = Basis(p_rotation);
+	double aligned = 0.0;
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 3; b++) {
+			aligned += rotation.rows[b][a] * cross_covariance[a][b];
+		}
+	}
+	Vector3 center_offset = p_rotation.xform(moved_center) - target_center;
+	double deviation = squared_norm_sum - 2.0 * aligned + weight_sum * (2.0 * p_translation.dot(center_offset) + p_translation.length_squared());
+	return MAX(deviation, 0.0) / weight_sum;
+}
+
 void QuaternionCharacteristicPolynomial::translate(Vector3 r_translate, PackedVector3Array &r_x) {
 	for (Vector3 &p : r_x) {
 		p += r_translate;
@@ -341,19 +593,27 @@ void QuaternionCharacteristicPolynomial::inner_product(PackedVector3Array &r_coo
 	sum_zy = 0;
 	sum_zz = 0;
 
+	moved_weighted_sum = Vector3();
+	target_weighted_sum = Vector3();
+
 	bool weight_is_empty = weight.is_empty();
 	int size = r_coords1.size();
+	const Vector3 *coords1 = r_coords1.ptr();
+	const Vector3 *coords2 = r_coords2.ptr();
 
 	for (int i = 0; i < size; i++) {
+		const Vector3 coord1 = coords1[i] - moved_center;
+		weighted_coord2 = coords2[i] - target_center;
 		if (!weight_is_empty) {
-			weighted_coord1 = weight[i] * r_coords1[i];
-			sum_of_squares1 += weighted_coord1.dot(r_coords1[i]);
+			weighted_coord1 = weight[i] * coord1;
+			sum_of_squares1 += weighted_coord1.dot(coord1);
+			target_weighted_sum += weight[i] * weighted_coord2;
 		} else {
-			weighted_coord1 = r_coords1[i];
+			weighted_coord1 = coord1;
 			sum_of_squares1 += weighted_coord1.dot(weighted_coord1);
+			target_weighted_sum += weighted_coord2;
 		}
-
-		weighted_coord2 = r_coords2[i];
+		moved_weighted_sum += weighted_coord1;
 
 		sum_of_squares2 += weight_is_empty ? weighted_coord2.dot(weighted_coord2) : (weight[i] * weighted_coord2.dot(weighted_coord2));
 
@@ -370,7 +630,12 @@ void QuaternionCharacteristicPolynomial::inner_product(PackedVector3Array &r_coo
 		sum_zz += (weighted_coord1.z * weighted_coord2.z);
 	}
 
-	double initial_eigenvalue = (sum_of_squares1 + sum_of_squares2) * 0.5;
+	squared_norm_sum = sum_of_squares1 + sum_of_squares2;
+	update_key_matrix_terms();
+}
+
+void QuaternionCharacteristicPolynomial::update_key_matrix_terms() {
+	double initial_eigenvalue = squared_norm_sum * 0.5;
 
 	sum_xz_plus_zx = sum_xz + sum_zx;
 	sum_yz_plus_zy = sum_yz + sum_zy;
@@ -400,12 +665,10 @@ void QuaternionCharacteristicPolynomial::set(PackedVector3Array &p_moved_param,
 	translate_enabled = p_translate_param;
 
 	if (translate_enabled) {
+		// inner_product() subtracts the centers as it reads the points, so the caller's arrays are never copied.
 		moved_center = move_to_weighted_center(p_moved_param, p_weight_param);
 		target_center = move_to_weighted_center(p_target_param, p_weight_param);
 
-		translate(moved_center * -1, moved);
-		translate(target_center * -1, target);
-
 		w_sum = 0;
 		if (!weight.is_empty()) {
 			for (int i = 0; i < weight.size(); i++) {
@@ -544,22 +807,20 @@ void QuaternionCharacteristicPolynomial::_bind_methods() {
 			&QuaternionCharacteristicPolynomial::weighted_superpose);
 }
 
-Array QuaternionCharacteristicPolynomial::weighted_superpose(PackedVector3Array p_moved,
-		PackedVector3Array p_target,
-		Vector<double> p_weight, bool p_translate,
-		double p_precision) {
+QuaternionCharacteristicPolynomial::Superposition QuaternionCharacteristicPolynomial::superpose(const PackedVector3Array &p_moved,
+		const PackedVector3Array &p_target,
+		const Vector<double> &p_weight, bool p_translate,
+		double p_precision, SuperpositionMethod p_method, bool p_residual) {
 	QuaternionCharacteristicPolynomial qcp(p_precision);
+	qcp.method = p_method;
+	Superposition result;
 
 	// Enhanced input validation
 	ValidationError validation_result = qcp.validate_inputs(p_moved, p_target, p_weight);
 	if (validation_result != VALIDATION_OK) {
 		// For degenerate cases, try to handle them gracefully
 		if (validation_result == ERROR_DEGENERATE_POINTS && p_moved.size() > 0) {
-			// For identical points, just compute the translation
-			Quaternion rotation = Quaternion(); // Identity rotation
-			Vector3 translation = Vector3();
-
-			if (p_translate && p_moved.size() > 0) {
+			if (p_translate) {
 				// Calculate translation as difference between centroids
 				Vector3 moved_center = Vector3();
 				Vector3 target_center = Vector3();
@@ -571,34 +832,442 @@ Array QuaternionCharacteristicPolynomial::weighted_superpose(PackedVector3Array
 
 				moved_center /= p_moved.size();
 				target_center /= p_target.size();
-				translation = target_center - moved_center;
+				result.translation = target_center - moved_center;
 			}
-
-			Array result;
-			result.push_back(rotation);
-			result.push_back(translation);
-			return result;
 		}
-
-		// Return error result for other validation failures
-		Array error_result;
-		error_result.push_back(Quaternion()); // Identity quaternion
-		error_result.push_back(Vector3()); // Zero translation
-		return error_result;
+		// Other validation failures keep the identity rotation and zero translation, with no residual to report.
+		return result;
 	}
 
-	Quaternion rotation;
-	Vector3 translation;
+	PackedVector3Array moved = p_moved;
+	PackedVector3Array target = p_target;
+	Vector<double> weight = p_weight;
 
 	// Use consistent algorithm for both single and multi-point cases
-	rotation = qcp._weighted_superpose(p_moved, p_target, p_weight, p_translate);
-	translation = qcp._get_translation();
+	result.rotation = qcp._weighted_superpose(moved, target, weight, p_translate);
+	result.translation = qcp._get_translation();
 
 	// Apply canonical form to ensure consistent quaternion representation
-	rotation = qcp.apply_canonical_form(rotation);
+	result.rotation = qcp.apply_canonical_form(result.rotation);
+	if (!p_residual) {
+		return result;
+	}
+
+	// The optimal residual follows from the largest eigenvalue of the key matrix.
+	result.weight_sum = qcp.w_sum;
+	if (result.weight_sum > 0.0) {
+		result.msd = MAX(qcp.squared_norm_sum - 2.0 * qcp.calculate_max_eigenvalue(), 0.0) / result.weight_sum;
+	}
+
+	// Undo the centering so the sums can score rotations about the original origin too.
+	result.moved_center = qcp.moved_center + qcp.moved_weighted_sum / result.weight_sum;
+	result.target_center = qcp.target_center + qcp.target_weighted_sum / result.weight_sum;
+	const double sums[3][3] = {
+		{ qcp.sum_xx, qcp.sum_xy, qcp.sum_xz },
+		{ qcp.sum_yx, qcp.sum_yy, qcp.sum_yz },
+		{ qcp.sum_zx, qcp.sum_zy, qcp.sum_zz },
+	};
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 3; b++) {
+			result.cross_covariance[a][b] = sums[a][b] + result.weight_sum * (double)qcp.moved_center[a] * (double)qcp.target_center[b];
+		}
+	}
+	result.squared_norm_sum = qcp.squared_norm_sum + result.weight_sum * (qcp.moved_center.length_squared() + qcp.target_center.length_squared());
+	return result;
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::begin() {
+	*this = Accumulator();
+}
 
+void QuaternionCharacteristicPolynomial::Accumulator::accumulate(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, int64_t p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	if (p_count == 0) {
+		return;
+	}
+	ERR_FAIL_NULL(p_moved);
+	ERR_FAIL_NULL(p_target);
+
+	// Two passes over the chunk: its own centroids, then its moments about them. Only the chunk is revisited.
+	Accumulator chunk;
+	for (int64_t i = 0; i < p_count; i++) {
+		double w = p_weight ? p_weight[i] : 1.0;
+		if (!(w > 0.0) || !Math::is_finite(w)) {
+			continue;
+		}
+		chunk.weight_sum += w;
+		for (int a = 0; a < 3; a++) {
+			chunk.moved_mean[a] += w * p_moved[i][a];
+			chunk.target_mean[a] += w * p_target[i][a];
+		}
+	}
+	if (chunk.weight_sum <= 0.0) {
+		return;
+	}
+	for (int a = 0; a < 3; a++) {
+		chunk.moved_mean[a] /= chunk.weight_sum;
+		chunk.target_mean[a] /= chunk.weight_sum;
+	}
+	for (int64_t i = 0; i < p_count; i++) {
+		double w = p_weight ? p_weight[i] : 1.0;
+		if (!(w > 0.0) || !Math::is_finite(w)) {
+			continue;
+		}
+		double moved_offset[3], target_offset[3];
+		for (int a = 0; a < 3; a++) {
+			moved_offset[a] = p_moved[i][a] - chunk.moved_mean[a];
+			target_offset[a] = p_target[i][a] - chunk.target_mean[a];
+			chunk.moved_squared_deviation += w * moved_offset[a] * moved_offset[a];
+			chunk.target_squared_deviation += w * target_offset[a] * target_offset[a];
+		}
+		for (int a = 0; a < 3; a++) {
+			for (int b = 0; b < 3; b++) {
+				chunk.co_moment[a][b] += w * moved_offset[a] * target_offset[b];
+			}
+		}
+	}
+	merge(chunk);
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::accumulate(const PackedVector3Array &p_moved, const PackedVector3Array &p_target, const Vector<double> &p_weight) {
+	ERR_FAIL_COND_MSG(p_moved.size() != p_target.size(), "Moved and target chunks must hold the same number of points.");
+	ERR_FAIL_COND_MSG(!p_weight.is_empty() && p_weight.size() != p_moved.size(), "Weights must be empty or match the number of points.");
+	accumulate(p_moved.ptr(), p_target.ptr(), p_weight.is_empty() ? nullptr : p_weight.ptr(), p_moved.size());
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::merge(const Accumulator &p_other) {
+	if (p_other.weight_sum <= 0.0) {
+		return;
+	}
+	if (weight_sum <= 0.0) {
+		*this = p_other;
+		return;
+	}
+	double total = weight_sum + p_other.weight_sum;
+	double blend = p_other.weight_sum / total;
+	double spread = weight_sum * blend; // weight_sum * p_other.weight_sum / total
+	double moved_delta[3], target_delta[3];
+	for (int a = 0; a < 3; a++) {
+		moved_delta[a] = p_other.moved_mean[a] - moved_mean[a];
+		target_delta[a] = p_other.target_mean[a] - target_mean[a];
+	}
+	for (int a = 0; a < 3; a++) {
+		moved_squared_deviation += moved_delta[a] * moved_delta[a] * spread;
+		target_squared_deviation += target_delta[a] * target_delta[a] * spread;
+		for (int b = 0; b < 3; b++) {
+			co_moment[a][b] += p_other.co_moment[a][b] + moved_delta[a] * target_delta[b] * spread;
+		}
+		moved_mean[a] += moved_delta[a] * blend;
+		target_mean[a] += target_delta[a] * blend;
+	}
+	moved_squared_deviation += p_other.moved_squared_deviation;
+	target_squared_deviation += p_other.target_squared_deviation;
+	weight_sum = total;
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::remove(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, int64_t p_count) {
+	Accumulator part;
+	part.accumulate(p_moved, p_target, p_weight, p_count);
+	unmerge(part);
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::remove(const PackedVector3Array &p_moved, const PackedVector3Array &p_target, const Vector<double> &p_weight) {
+	ERR_FAIL_COND_MSG(p_moved.size() != p_target.size(), "Moved and target chunks must hold the same number of points.");
+	ERR_FAIL_COND_MSG(!p_weight.is_empty() && p_weight.size() != p_moved.size(), "Weights must be empty or match the number of points.");
+	remove(p_moved.ptr(), p_target.ptr(), p_weight.is_empty() ? nullptr : p_weight.ptr(), p_moved.size());
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::unmerge(const Accumulator &p_part) {
+	if (p_part.weight_sum <= 0.0) {
+		return;
+	}
+	double remaining = weight_sum - p_part.weight_sum;
+	// Nothing meaningful is left once the weight is gone; rounding would only leave noise in the moments.
+	if (remaining <= weight_sum * 1e-12) {
+		begin();
+		return;
+	}
+	// The inverse of merge(): solve the pairwise update for the moments of what remains.
+	double spread = remaining * p_part.weight_sum / weight_sum;
+	double moved_delta[3], target_delta[3];
+	for (int a = 0; a < 3; a++) {
+		double remaining_moved_mean = (weight_sum * moved_mean[a] - p_part.weight_sum * p_part.moved_mean[a]) / remaining;
+		double remaining_target_mean = (weight_sum * target_mean[a] - p_part.weight_sum * p_part.target_mean[a]) / remaining;
+		moved_delta[a] = p_part.moved_mean[a] - remaining_moved_mean;
+		target_delta[a] = p_part.target_mean[a] - remaining_target_mean;
+		moved_mean[a] = remaining_moved_mean;
+		target_mean[a] = remaining_target_mean;
+	}
+	for (int a = 0; a < 3; a++) {
+		moved_squared_deviation -= moved_delta[a] * moved_delta[a] * spread;
+		target_squared_deviation -= target_delta[a] * target_delta[a] * spread;
+		for (int b = 0; b < 3; b++) {
+			co_moment[a][b] -= p_part.co_moment[a][b] + moved_delta[a] * target_delta[b] * spread;
+		}
+	}
+	moved_squared_deviation = MAX(moved_squared_deviation - p_part.moved_squared_deviation, 0.0);
+	target_squared_deviation = MAX(target_squared_deviation - p_part.target_squared_deviation, 0.0);
+	weight_sum = remaining;
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::transform_moved(const Basis &p_rotation, const Vector3 &p_translation) {
+	// Moments about the centroid only see the rotation: the co-moment becomes R * C, and lengths are unchanged.
+	double rotated_mean[3];
+	double rotated_co_moment[3][3];
+	for (int a = 0; a < 3; a++) {
+		rotated_mean[a] = p_translation[a];
+		for (int b = 0; b < 3; b++) {
+			rotated_mean[a] += p_rotation.rows[a][b] * moved_mean[b];
+			rotated_co_moment[a][b] = 0.0;
+			for (int k = 0; k < 3; k++) {
+				rotated_co_moment[a][b] += p_rotation.rows[a][k] * co_moment[k][b];
+			}
+		}
+	}
+	for (int a = 0; a < 3; a++) {
+		moved_mean[a] = rotated_mean[a];
+		for (int b = 0; b < 3; b++) {
+			co_moment[a][b] = rotated_co_moment[a][b];
+		}
+	}
+}
+
+void QuaternionCharacteristicPolynomial::Accumulator::transform_target(const Basis &p_rotation, const Vector3 &p_translation) {
+	// The co-moment becomes C * R^T, since the target is its second index.
+	double rotated_mean[3];
+	double rotated_co_moment[3][3];
+	for (int a = 0; a < 3; a++) {
+		rotated_mean[a] = p_translation[a];
+		for (int b = 0; b < 3; b++) {
+			rotated_mean[a] += p_rotation.rows[a][b] * target_mean[b];
+			rotated_co_moment[a][b] = 0.0;
+			for (int k = 0; k < 3; k++) {
+				rotated_co_moment[a][b] += co_moment[a][k] * p_rotation.rows[b][k];
+			}
+		}
+	}
+	for (int a = 0; a < 3; a++) {
+		target_mean[a] = rotated_mean[a];
+		for (int b = 0; b < 3; b++) {
+			co_moment[a][b] = rotated_co_moment[a][b];
+		}
+	}
+}
+
+QuaternionCharacteristicPolynomial::Superposition QuaternionCharacteristicPolynomial::Accumulator::solve(bool p_translate, double p_precision, SuperpositionMethod p_method) const {
+	Superposition result;
+	if (weight_sum <= 0.0) {
+		return result;
+	}
+	result.weight_sum = weight_sum;
+	result.moved_center = Vector3(moved_mean[0], moved_mean[1], moved_mean[2]);
+	result.target_center = Vector3(target_mean[0], target_mean[1], target_mean[2]);
+	double moved_mean_length_squared = 0.0, target_mean_length_squared = 0.0;
+	for (int a = 0; a < 3; a++) {
+		moved_mean_length_squared += moved_mean[a] * moved_mean[a];
+		target_mean_length_squared += target_mean[a] * target_mean[a];
+		for (int b = 0; b < 3; b++) {
+			result.cross_covariance[a][b] = co_moment[a][b] + weight_sum * moved_mean[a] * target_mean[b];
+		}
+	}
+	result.squared_norm_sum = moved_squared_deviation + target_squared_deviation + weight_sum * (moved_mean_length_squared + target_mean_length_squared);
+
+	// Translating fits the centered moments; otherwise the rotation is about the origin and needs the raw sums.
+	const double(*sums)[3] = p_translate ? co_moment : result.cross_covariance;
+	QuaternionCharacteristicPolynomial qcp(p_precision);
+	qcp.sum_xx = sums[0][0];
+	qcp.sum_xy = sums[0][1];
+	qcp.sum_xz = sums[0][2];
+	qcp.sum_yx = sums[1][0];
+	qcp.sum_yy = sums[1][1];
+	qcp.sum_yz = sums[1][2];
+	qcp.sum_zx = sums[2][0];
+	qcp.sum_zy = sums[2][1];
+	qcp.sum_zz = sums[2][2];
+	qcp.squared_norm_sum = p_translate ? moved_squared_deviation + target_squared_deviation : result.squared_norm_sum;
+	qcp.update_key_matrix_terms();
+
+	result.rotation = qcp.apply_canonical_form(qcp.calculate_rotation(p_method));
+	if (p_translate) {
+		result.translation = result.target_center - result.rotation.xform(result.moved_center);
+	}
+	result.msd = MAX(qcp.squared_norm_sum - 2.0 * qcp.calculate_max_eigenvalue(), 0.0) / weight_sum;
+	return result;
+}
+
+template <typename T>
+void QuaternionCharacteristicPolynomial::weighted_superpose_batch(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight,
+		int p_point_count, int p_problem_count, int p_problem_stride,
+		Quaternion *r_rotations, double *r_msd, double p_precision) {
+	ERR_FAIL_COND(p_point_count < 0 || p_problem_count < 0 || p_problem_stride < p_problem_count);
+	ERR_FAIL_NULL(r_rotations);
+	if (p_problem_count == 0) {
+		return;
+	}
+	ERR_FAIL_COND(p_point_count > 0 && (!p_moved || !p_target || !p_weight));
+
+	constexpr int LANES = BATCH_LANES * int(sizeof(double) / sizeof(T));
+	// Newton's method stops near the scalar's own resolution.
+	const T eigenvalue_precision = sizeof(T) < sizeof(double) ? T(1e-6) : T(1e-11);
+
+	double weight_sum = 0.0;
+	for (int i = 0; i < p_point_count; i++) {
+		weight_sum += p_weight[i];
+	}
+
+	// Every loop over lanes has a fixed trip count and no branches, so the compiler can keep a block of problems in vector registers.
+	for (int first = 0; first < p_problem_count; first += LANES) {
+		const int lane_count = MIN(LANES, p_problem_count - first);
+		T s[9][LANES] = {}; // sum_xx, sum_xy, sum_xz, sum_yx, ..., sum_zz.
+		T squares[LANES] = {};
+
+		for (int i = 0; i < p_point_count; i++) {
+			const Vector3 *moved = p_moved + (int64_t)i * p_problem_stride + first;
+			const Vector3 *target = p_target + (int64_t)i * p_problem_stride + first;
+			const T w = T(p_weight[i]);
+			T mx[LANES] = {}, my[LANES] = {}, mz[LANES] = {};
+			T tx[LANES] = {}, ty[LANES] = {}, tz[LANES] = {};
+			for (int lane = 0; lane < lane_count; lane++) {
+				mx[lane] = moved[lane].x;
+				my[lane] = moved[lane].y;
+				mz[lane] = moved[lane].z;
+				tx[lane] = target[lane].x;
+				ty[lane] = target[lane].y;
+				tz[lane] = target[lane].z;
+			}
+			for (int lane = 0; lane < LANES; lane++) {
+				const T wx = w * mx[lane], wy = w * my[lane], wz = w * mz[lane];
+				squares[lane] += wx * mx[lane] + wy * my[lane] + wz * mz[lane] + w * (tx[lane] * tx[lane] + ty[lane] * ty[lane] + tz[lane] * tz[lane]);
+				s[0][lane] += wx * tx[lane];
+				s[1][lane] += wx * ty[lane];
+				s[2][lane] += wx * tz[lane];
+				s[3][lane] += wy * tx[lane];
+				s[4][lane] += wy * ty[lane];
+				s[5][lane] += wy * tz[lane];
+				s[6][lane] += wz * tx[lane];
+				s[7][lane] += wz * ty[lane];
+				s[8][lane] += wz * tz[lane];
+			}
+		}
+
+		// The eigenvector is the first column of the adjoint of the key matrix shifted by the initial eigenvalue, as in calculate_rotation().
+		T q[4][LANES];
+		T qsqr[LANES];
+		for (int lane = 0; lane < LANES; lane++) {
+			const T sxx = s[0][lane], sxy = s[1][lane], sxz = s[2][lane];
+			const T syx = s[3][lane], syy = s[4][lane], syz = s[5][lane];
+			const T szx = s[6][lane], szy = s[7][lane], szz = s[8][lane];
+			const T eigenvalue = squares[lane] * T(0.5);
+			const T a21 = syz - szy;
+			const T a22 = sxx - syy - szz - eigenvalue;
+			const T a23 = sxy + syx;
+			const T a24 = sxz + szx;
+			const T a31 = -(sxz - szx);
+			const T a32 = a23;
+			const T a33 = syy - sxx - szz - eigenvalue;
+			const T a34 = syz + szy;
+			const T a41 = sxy - syx;
+			const T a42 = a24;
+			const T a43 = a34;
+			const T a44 = szz - sxx - syy - eigenvalue;
+			const T a3344_4334 = a33 * a44 - a43 * a34;
+			const T a3244_4234 = a32 * a44 - a42 * a34;
+			const T a3243_4233 = a32 * a43 - a42 * a33;
+			const T a3143_4133 = a31 * a43 - a41 * a33;
+			const T a3144_4134 = a31 * a44 - a41 * a34;
+			const T a3142_4132 = a31 * a42 - a41 * a32;
+			q[0][lane] = a22 * a3344_4334 - a23 * a3244_4234 + a24 * a3243_4233;
+			q[1][lane] = -a21 * a3344_4334 + a23 * a3144_4134 - a24 * a3143_4133;
+			q[2][lane] = a21 * a3244_4234 - a22 * a3144_4134 + a24 * a3142_4132;
+			q[3][lane] = -a21 * a3243_4233 + a22 * a3143_4133 - a23 * a3142_4132;
+			qsqr[lane] = q[0][lane] * q[0][lane] + q[1][lane] * q[1][lane] + q[2][lane] * q[2][lane] + q[3][lane] * q[3][lane];
+		}
+
+		for (int lane = 0; lane < lane_count; lane++) {
+			Quaternion rotation;
+			if (qsqr[lane] >= p_precision) {
+				const double norm = Math::sqrt(double(qsqr[lane]));
+				rotation = Quaternion(q[1][lane] / norm, q[2][lane] / norm, q[3][lane] / norm, q[0][lane] / norm);
+			} else {
+				// The first column vanished; the scalar path walks the remaining columns.
+				QuaternionCharacteristicPolynomial qcp(p_precision);
+				qcp.sum_xx = s[0][lane];
+				qcp.sum_xy = s[1][lane];
+				qcp.sum_xz = s[2][lane];
+				qcp.sum_yx = s[3][lane];
+				qcp.sum_yy = s[4][lane];
+				qcp.sum_yz = s[5][lane];
+				qcp.sum_zx = s[6][lane];
+				qcp.sum_zy = s[7][lane];
+				qcp.sum_zz = s[8][lane];
+				qcp.squared_norm_sum = squares[lane];
+				qcp.update_key_matrix_terms();
+				rotation = qcp.calculate_rotation();
+			}
+			r_rotations[first + lane] = rotation.w < 0.0 ? -rotation : rotation;
+		}
+
+		if (!r_msd) {
+			continue;
+		}
+
+		// Newton-Raphson on every lane's characteristic polynomial at once, as in calculate_max_eigenvalue().
+		T c0[LANES], c1[LANES], c2[LANES], eigenvalue[LANES];
+		for (int lane = 0; lane < LANES; lane++) {
+			const T sxx = s[0][lane], sxy = s[1][lane], sxz = s[2][lane];
+			const T syx = s[3][lane], syy = s[4][lane], syz = s[5][lane];
+			const T szx = s[6][lane], szy = s[7][lane], szz = s[8][lane];
+			const T sxx2 = sxx * sxx, syy2 = syy * syy, szz2 = szz * szz;
+			const T sxy2 = sxy * sxy, syz2 = syz * syz, sxz2 = sxz * sxz;
+			const T syx2 = syx * syx, szy2 = szy * szy, szx2 = szx * szx;
+			const T syz_szy_m_syy_szz2 = T(2.0) * (syz * szy - syy * szz);
+			const T sxx2_syy2_szz2_syz2_szy2 = syy2 + szz2 - sxx2 + syz2 + szy2;
+			const T sxy2_sxz2_syx2_szx2 = syx2 + szx2 - sxy2 - sxz2;
+			const T sxz_p_szx = sxz + szx, syz_p_szy = syz + szy, sxy_p_syx = sxy + syx;
+			const T syz_m_szy = syz - szy, sxz_m_szx = sxz - szx, sxy_m_syx = sxy - syx;
+			const T sxx_p_syy = sxx + syy, sxx_m_syy = sxx - syy;
+			c2[lane] = -T(2.0) * (sxx2 + syy2 + szz2 + sxy2 + syx2 + sxz2 + szx2 + syz2 + szy2);
+			c1[lane] = T(8.0) * (sxx * syz * szy + syy * szx * sxz + szz * sxy * syx - sxx * syy * szz - syz * szx * sxy - szy * syx * sxz);
+			c0[lane] = sxy2_sxz2_syx2_szx2 * sxy2_sxz2_syx2_szx2 +
+					(sxx2_syy2_szz2_syz2_szy2 + syz_szy_m_syy_szz2) * (sxx2_syy2_szz2_syz2_szy2 - syz_szy_m_syy_szz2) +
+					(-sxz_p_szx * syz_m_szy + sxy_m_syx * (sxx_m_syy - szz)) * (-sxz_m_szx * syz_p_szy + sxy_m_syx * (sxx_m_syy + szz)) +
+					(-sxz_p_szx * syz_p_szy - sxy_p_syx * (sxx_p_syy - szz)) * (-sxz_m_szx * syz_m_szy - sxy_p_syx * (sxx_p_syy + szz)) +
+					(sxy_p_syx * syz_p_szy + sxz_p_szx * (sxx_m_syy + szz)) * (-sxy_m_syx * syz_m_szy + sxz_p_szx * (sxx_p_syy + szz)) +
+					(sxy_p_syx * syz_m_szy + sxz_m_szx * (sxx_m_syy - szz)) * (-sxy_m_syx * syz_p_szy + sxz_m_szx * (sxx_p_syy - szz));
+			eigenvalue[lane] = squares[lane] * T(0.5);
+		}
+		for (int iteration = 0; iteration < 50; iteration++) {
+			bool converged = true;
+			for (int lane = 0; lane < LANES; lane++) {
+				const T x2 = eigenvalue[lane] * eigenvalue[lane];
+				const T b = (x2 + c2[lane]) * eigenvalue[lane];
+				const T a = b + c1[lane];
+				const T derivative = T(2.0) * x2 * eigenvalue[lane] + b + a;
+				const T step = derivative != T(0.0) ? (a * eigenvalue[lane] + c0[lane]) / derivative : T(0.0);
+				eigenvalue[lane] -= step;
+				converged = converged && Math::abs(step) <= Math::abs(eigenvalue_precision * eigenvalue[lane]);
+			}
+			if (converged) {
+				break;
+			}
+		}
+		for (int lane = 0; lane < lane_count; lane++) {
+			r_msd[first + lane] = weight_sum > 0.0 ? MAX(double(squares[lane]) - 2.0 * double(eigenvalue[lane]), 0.0) / weight_sum : 0.0;
+		}
+	}
+}
+
+template void QuaternionCharacteristicPolynomial::weighted_superpose_batch<float>(const Vector3 *, const Vector3 *, const double *, int, int, int, Quaternion *, double *, double);
+template void QuaternionCharacteristicPolynomial::weighted_superpose_batch<double>(const Vector3 *, const Vector3 *, const double *, int, int, int, Quaternion *, double *, double);
+
+Array QuaternionCharacteristicPolynomial::weighted_superpose(PackedVector3Array p_moved,
+		PackedVector3Array p_target,
+		Vector<double> p_weight, bool p_translate,
+		double p_precision) {
+	Superposition superposition = superpose(p_moved, p_target, p_weight, p_translate, p_precision);
 	Array result;
-	result.push_back(rotation);
-	result.push_back(translation);
+	result.push_back(superposition.rotation);
+	result.push_back(superposition.translation);
+	result.push_back(superposition.msd);
 	return result;
 }
@@ -34,6 +34,7 @@
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/variant/variant.h"
+#include "ik_scalar.h"
 
 /**
  * Implementation of the Quaternion-Based Characteristic Polynomial algorithm
@@ -69,7 +70,18 @@
 
 class QuaternionCharacteristicPolynomial : Object {
 	GDCLASS(QuaternionCharacteristicPolynomial, Object);
+
+public:
+	// How the optimal rotation is extracted from the weighted sums. All three minimize the same deviation.
+	enum SuperpositionMethod {
+		METHOD_QCP, // Adjoint eigenvector of the key matrix, shifted by an upper bound of its largest eigenvalue.
+		METHOD_HORN, // Largest eigenvalue from the key matrix's quartic in closed form (Ferrari), then its adjoint eigenvector.
+		METHOD_KABSCH, // Rotation from a 3x3 singular value decomposition of the cross-covariance, by cyclic Jacobi sweeps.
+	};
+
+private:
 	double eigenvector_precision = 1E-6;
+	SuperpositionMethod method = METHOD_QCP;
 
 	PackedVector3Array target, moved;
 	Vector<double> weight;
@@ -83,6 +95,8 @@ class QuaternionCharacteristicPolynomial : Object {
 	double sum_xx_plus_yy = 0, sum_zz = 0, max_eigenvalue = 0, sum_yz_minus_zy = 0, sum_xz_minus_zx = 0, sum_xy_minus_yx = 0;
 	double sum_xx_minus_yy = 0, sum_xy_plus_yx = 0, sum_xz_plus_zx = 0;
 	double sum_yy = 0, sum_xx = 0, sum_yz_plus_zy = 0;
+	double squared_norm_sum = 0; // Weighted squared lengths of both point sets, after centering.
+	Vector3 moved_weighted_sum, target_weighted_sum; // Weighted sums of the points as passed to inner_product().
 	bool transformation_calculated = false, inner_product_calculated = false;
 
 	// Enhanced validation and error handling
@@ -121,6 +135,12 @@ private:
 	void inner_product(PackedVector3Array &coords1, PackedVector3Array &coords2);
 	void set(PackedVector3Array &r_target, PackedVector3Array &r_moved);
 	Quaternion calculate_rotation();
+	double calculate_max_eigenvalue() const;
+	void calculate_characteristic_polynomial(double &r_c2, double &r_c1, double &r_c0) const;
+	Quaternion calculate_rotation_horn() const;
+	Quaternion calculate_rotation_kabsch() const;
+	Quaternion calculate_rotation(SuperpositionMethod p_method);
+	void update_key_matrix_terms();
 	void set(PackedVector3Array &p_moved, PackedVector3Array &p_target, Vector<double> &p_weight, bool p_translate);
 	static void translate(Vector3 r_translate, PackedVector3Array &r_x);
 	Vector3 move_to_weighted_center(PackedVector3Array &r_to_center, Vector<double> &r_weight);
@@ -133,6 +153,66 @@ protected:
 	static void _bind_methods();
 
 public:
+	// Everything needed to score a rotation of the moved points against the targets, without revisiting the points.
+	struct Superposition {
+		Quaternion rotation;
+		Vector3 translation;
+		double msd = 0.0; // Weighted mean squared deviation left after applying rotation and translation, if asked for.
+		double weight_sum = 0.0;
+		double squared_norm_sum = 0.0; // Weighted squared lengths of both point sets, uncentered.
+		double cross_covariance[3][3] = {}; // Weighted sum of moved[a] * target[b], uncentered.
+		Vector3 moved_center, target_center;
+
+		double get_msd(const Quaternion &p_rotation, const Vector3 &p_translation = Vector3()) const;
+	};
+
+	// Streams weighted point pairs into the sums a superposition needs, in constant memory and without copying the points.
+	// Moments are kept about the running weighted centroids (Chan et al.), so clouds far from the origin keep their precision.
+	// Accumulators filled from disjoint chunks on separate threads can be merged before solving.
+	// Slowly changing sets can be kept up to date instead of rebuilt: points can be removed again, and a rigid motion
+	// of every moved or every target point only transforms the stored moments.
+	struct Accumulator {
+		double weight_sum = 0.0;
+		double moved_mean[3] = {};
+		double target_mean[3] = {};
+		double moved_squared_deviation = 0.0; // Weighted sum of |moved - moved_mean|^2.
+		double target_squared_deviation = 0.0;
+		double co_moment[3][3] = {}; // Weighted sum of (moved - moved_mean)[a] * (target - target_mean)[b].
+
+		void begin();
+		// p_weight may be null for unit weights. Pairs with a non-positive or non-finite weight are skipped.
+		void accumulate(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, int64_t p_count);
+		void accumulate(const PackedVector3Array &p_moved, const PackedVector3Array &p_target, const Vector<double> &p_weight = Vector<double>());
+		void merge(const Accumulator &p_other);
+		// Removes points that were accumulated before, given with the same weights.
+		void remove(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight, int64_t p_count);
+		void remove(const PackedVector3Array &p_moved, const PackedVector3Array &p_target, const Vector<double> &p_weight = Vector<double>());
+		// Takes out an accumulator that was merged in before.
+		void unmerge(const Accumulator &p_part);
+		void transform_moved(const Basis &p_rotation, const Vector3 &p_translation = Vector3());
+		void transform_target(const Basis &p_rotation, const Vector3 &p_translation = Vector3());
+		Superposition solve(bool p_translate, double p_precision = 1E-6, SuperpositionMethod p_method = METHOD_QCP) const;
+	};
+
+	// Problems solved side by side by weighted_superpose_batch() in double precision; its inner loops run over this many lanes.
+	// Float kernels run twice as many, to fill the same vector width.
+	static constexpr int BATCH_LANES = 4;
+
+	// Solves p_problem_count independent rotation-only superpositions that share p_point_count points and their weights.
+	// Point i of problem j lives at [i * p_problem_stride + j], so consecutive problems fill consecutive lanes.
+	// r_msd may be null. Problems with no usable rotation get the identity.
+	// T is the scalar the sums are accumulated in; instantiated for float and double.
+	template <typename T = ik_scalar_t>
+	static void weighted_superpose_batch(const Vector3 *p_moved, const Vector3 *p_target, const double *p_weight,
+			int p_point_count, int p_problem_count, int p_problem_stride,
+			Quaternion *r_rotations, double *r_msd = nullptr, double p_precision = 1E-6);
+
+	// Without p_residual only the rotation and translation are filled in: msd and the sums get_msd() scores with are
+	// left empty, which spares the eigenvalue solve for callers that never score the fit.
+	static Superposition superpose(const PackedVector3Array &p_moved,
+			const PackedVector3Array &p_target,
+			const Vector<double> &p_weight, bool p_translate,
+			double p_precision = 1E-6, SuperpositionMethod p_method = METHOD_QCP, bool p_residual = true);
 	static Array weighted_superpose(PackedVector3Array p_moved,
 			PackedVector3Array p_target,
 			Vector<double> p_weight, bool p_translate,
@@ -0,0 +1,265 @@
+/**************************************************************************/
+/*  test_ik_bone_segment_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_bone_segment_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/os/os.h"
+#include "scene/3d/camera_3d.h"
+
+namespace TestIKBoneSegment3D {
+
+using namespace TestManyBoneIK3DHelpers;
+
+static Ref<IKBoneSegment3D> find_leg_segment(EWBIK3D *p_ik) {
+	Vector<Ref<IKBoneSegment3D>> roots = p_ik->get_segmented_skeletons();
+	if (roots.is_empty() || roots[0]->get_child_segments().is_empty()) {
+		return Ref<IKBoneSegment3D>();
+	}
+	return roots[0]->get_child_segments()[0];
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKBoneSegment3D] Two-bone chains reach their pin in one iteration") {
+	IKRig rig = create_leg_rig();
+	add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+	// Keep the hips from chasing the foot so only the leg segment moves.
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	const Vector3 target = Vector3(0.1, 0.4, 0.3);
+	add_pin(rig, "foot", Transform3D(Basis(), target));
+	rig.ik->set_iterations_per_frame(1);
+
+	solve_frame(rig);
+	Ref<IKBoneSegment3D> leg = find_leg_segment(rig.ik);
+	REQUIRE(leg.is_valid());
+	CHECK(leg->is_two_bone_chain());
+	const real_t fast_error = get_bone_origin(rig, "foot").distance_to(target);
+	CHECK(fast_error < 1e-3);
+	// The limb lengths must survive the closed form solution.
+	CHECK(get_bone_origin(rig, "thigh").distance_to(get_bone_origin(rig, "shin")) == doctest::Approx(Vector3(0, -0.45, 0.02).length()));
+
+	rig.skeleton->reset_bone_poses();
+	rig.ik->set_two_bone_fast_path(false);
+	solve_frame(rig);
+	leg = find_leg_segment(rig.ik);
+	REQUIRE(leg.is_valid());
+	CHECK_FALSE(leg->is_two_bone_chain());
+	CHECK(get_bone_origin(rig, "foot").distance_to(target) > fast_error);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKBoneSegment3D] Two-bone chains clamp unreachable targets to full extension") {
+	IKRig rig = create_leg_rig();
+	add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.1, -3.0, 0)));
+
+	solve_frame(rig);
+	const Vector3 foot = get_bone_origin(rig, "foot");
+	CHECK(foot.is_finite());
+	CHECK(foot.y < 0.2);
+	CHECK(Math::abs(foot.x - 0.1) < 1e-2);
+
+	free_rig(rig);
+}
+
+// Solves a 200-bone chain for a fixed number of frames and returns the tip's distance to its pin, and optionally the time spent.
+static real_t solve_long_chain(EWBIK3D::BoneUpdateMode p_mode, int32_t p_frames, uint64_t *r_usec = nullptr) {
+	const int32_t bone_count = 200;
+	IKRig rig = create_chain_rig(bone_count, 0.01);
+	add_pin(rig, "root", Transform3D());
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	const Vector3 target = Vector3(0.8, 1.2, 0.4);
+	add_pin(rig, vformat("bone_%d", bone_count - 1), Transform3D(Basis(), target));
+	rig.ik->set_pin_direction_priorities(1, Vector3());
+	rig.ik->set_bone_update_mode(p_mode);
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int32_t frame_i = 0; frame_i < p_frames; frame_i++) {
+		solve_frame(rig);
+	}
+	if (r_usec) {
+		*r_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	}
+	Ref<IKBoneSegment3D> chain = find_leg_segment(rig.ik);
+	CHECK(chain.is_valid());
+	CHECK(chain.is_valid() && chain->is_jacobi_update() == (p_mode == EWBIK3D::BONE_UPDATE_JACOBI));
+	const real_t distance = get_bone_origin(rig, vformat("bone_%d", bone_count - 1)).distance_to(target);
+	free_rig(rig);
+	return distance;
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKBoneSegment3D] Jacobi bone updates converge on a long chain") {
+	const real_t start_distance = Vector3(0.8, 1.2, 0.4).distance_to(Vector3(0, 2.0, 0));
+	real_t previous_jacobi_distance = start_distance;
+	for (int32_t frames : { 1, 5, 20 }) {
+		const real_t gauss_seidel_distance = solve_long_chain(EWBIK3D::BONE_UPDATE_GAUSS_SEIDEL, frames);
+		const real_t jacobi_distance = solve_long_chain(EWBIK3D::BONE_UPDATE_JACOBI, frames);
+		CHECK(Math::is_finite(jacobi_distance));
+		// Every frame brings the tip closer.
+		CHECK(jacobi_distance < previous_jacobi_distance);
+		previous_jacobi_distance = jacobi_distance;
+		if (frames == 20) {
+			// Damped bones keep their whole share of the sweep, so the chain's length does not slow it down.
+			CHECK(jacobi_distance <= 1.5 * gauss_seidel_distance + 0.005);
+		}
+	}
+}
+
+// Timings are too noisy for the unit run; run with --no-skip to see them.
+TEST_CASE("[Benchmark][SceneTree][Modules][ManyBoneIK][IKBoneSegment3D] Convergence per wall clock of Jacobi and Gauss-Seidel on a long chain" * doctest::skip()) {
+	for (int32_t frames : { 1, 5, 20 }) {
+		uint64_t gauss_seidel_usec = 0;
+		uint64_t jacobi_usec = 0;
+		const real_t gauss_seidel_distance = solve_long_chain(EWBIK3D::BONE_UPDATE_GAUSS_SEIDEL, frames, &gauss_seidel_usec);
+		const real_t jacobi_distance = solve_long_chain(EWBIK3D::BONE_UPDATE_JACOBI, frames, &jacobi_usec);
+		MESSAGE(vformat("%d frames: Gauss-Seidel %.4f from the target in %d usec, Jacobi %.4f in %d usec.", frames, gauss_seidel_distance, gauss_seidel_usec, jacobi_distance, jacobi_usec));
+		CHECK(Math::is_finite(jacobi_distance));
+	}
+}
+
+// Memory only tracks its usage in debug builds, which is where the tests run.
+// Live bytes catch growth. The peak catches a buffer freed and allocated again each frame, but only when it would rise above the
+// peak an earlier test already reached, since the peak cannot be reset.
+#ifdef DEBUG_ENABLED
+template <typename F>
+static void check_steady_state_does_not_leak(IKRig &r_rig, F p_before_frame) {
+	// The first frames build the segments and size every scratch buffer.
+	for (int32_t frame_i = 0; frame_i < 2; frame_i++) {
+		p_before_frame(frame_i);
+		solve_frame(r_rig);
+	}
+	const uint64_t usage_before = Memory::get_mem_usage();
+	const uint64_t peak_before = Memory::get_mem_max_usage();
+	for (int32_t frame_i = 2; frame_i < 32; frame_i++) {
+		p_before_frame(frame_i);
+		solve_frame(r_rig);
+	}
+	CHECK(Memory::get_mem_usage() == usage_before);
+	CHECK(Memory::get_mem_max_usage() == peak_before);
+}
+
+static void check_steady_state_does_not_leak(IKRig &r_rig) {
+	check_steady_state_does_not_leak(r_rig, [](int32_t) {});
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKBoneSegment3D] Steady-state solves do not leak") {
+	SUBCASE("Translating root segment and two-bone leg") {
+		IKRig rig = create_leg_rig();
+		add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+		add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.1, 0.4, 0.3)));
+		rig.ik->set_iterations_per_frame(4);
+		check_steady_state_does_not_leak(rig);
+		free_rig(rig);
+	}
+	SUBCASE("Constrained chain") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "bone_11", Transform3D(Basis(), Vector3(0.5, 0.6, 0.2)));
+		rig.ik->add_constraint();
+		rig.ik->set_constraint_name_at_index(0, "bone_5");
+		rig.ik->set_kusudama_open_cone_count(0, 1);
+		rig.ik->set_kusudama_open_cone_center(0, 0, Vector3(0, 1, 0));
+		rig.ik->set_kusudama_open_cone_radius(0, 0, 0.4);
+		rig.ik->set_joint_twist(0, Vector2(-0.2, 0.4));
+		rig.ik->set_constraint_mode(true);
+		check_steady_state_does_not_leak(rig);
+		free_rig(rig);
+	}
+	SUBCASE("Jacobi chain") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "bone_11", Transform3D(Basis(), Vector3(0.5, 0.6, 0.2)));
+		rig.ik->set_bone_update_mode(EWBIK3D::BONE_UPDATE_JACOBI);
+		check_steady_state_does_not_leak(rig);
+		free_rig(rig);
+	}
+	SUBCASE("Tick interpolation") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "bone_11", Transform3D(Basis(), Vector3(0.5, 0.6, 0.2)));
+		rig.ik->set_solve_rate(30.0f);
+		check_steady_state_does_not_leak(rig);
+		free_rig(rig);
+	}
+	SUBCASE("Sleep") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "bone_11", Transform3D(Basis(), Vector3(0.5, 0.6, 0.2)));
+		rig.ik->set_sleep_translation_threshold(1e-3f);
+		rig.ik->set_sleep_rotation_threshold(1e-3f);
+		check_steady_state_does_not_leak(rig);
+		free_rig(rig);
+	}
+	SUBCASE("Pin queue drain") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "root", Transform3D());
+		rig.ik->set_pin_count(2);
+		rig.ik->set_pin_bone_name(1, "bone_11");
+		rig.ik->set_pin_target_interpolation_delay(0.05f);
+		check_steady_state_does_not_leak(rig, [&](int32_t p_frame) {
+			const double now = double(OS::get_singleton()->get_ticks_usec()) / 1000000.0;
+			const Vector3 target = Vector3(0.5, 0.6, 0.2) + Vector3(0.01, 0.0, 0.0) * (p_frame % 4);
+			rig.ik->push_pin_target(1, Transform3D(Basis(), target), now);
+		});
+		free_rig(rig);
+	}
+	SUBCASE("LOD") {
+		IKRig rig = create_chain_rig(12, 0.1);
+		add_pin(rig, "root", Transform3D());
+		add_pin(rig, "bone_11", Transform3D(Basis(), Vector3(0.5, 0.6, 0.2)));
+		add_pin(rig, "bone_5", Transform3D(Basis(), Vector3(0.2, 0.4, 0.0)));
+		rig.ik->set_pin_weight(2, 0.1f);
+		Camera3D *camera = memnew(Camera3D);
+		rig.scene->add_child(camera);
+		camera->make_current();
+		PackedFloat32Array thresholds;
+		thresholds.push_back(5.0f);
+		thresholds.push_back(10.0f);
+		rig.ik->set_lod_thresholds(thresholds);
+		camera->set_global_position(rig.skeleton->get_global_position() + Vector3(0, 0, 20.0));
+		check_steady_state_does_not_leak(rig);
+		CHECK(rig.ik->get_lod_tier() == 2);
+		free_rig(rig);
+	}
+	SUBCASE("Partial solve") {
+		IKRig rig = create_leg_rig();
+		add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+		Node3D *foot_target = add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.1, 0.4, 0.3)));
+		rig.ik->set_partial_solve(true);
+		check_steady_state_does_not_leak(rig, [&](int32_t p_frame) {
+			const Vector3 target = Vector3(0.1, 0.4, 0.3) + Vector3(0.02, 0.0, 0.0) * (p_frame % 2);
+			foot_target->set_global_position(rig.skeleton->get_global_transform().xform(target));
+		});
+		CHECK(rig.ik->get_last_solved_segment_count() > 0);
+		free_rig(rig);
+	}
+}
+#endif // DEBUG_ENABLED
+
+} // namespace TestIKBoneSegment3D
@@ -290,4 +290,59 @@ TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Check limit cones clear functiona
 	open_cones = kusudama->get_open_cones();
 	CHECK(open_cones.size() == 0); // Expect no limit cones to remain
 }
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudama3D] Batched point queries match per-point queries") {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+
+	Ref<IKLimitCone3D> cone_a;
+	cone_a.instantiate();
+	cone_a->set_attached_to(kusudama);
+	cone_a->set_radius(Math::PI / 6);
+	cone_a->set_control_point(Vector3(0, 0, 1));
+	kusudama->add_open_cone(cone_a);
+
+	Ref<IKLimitCone3D> cone_b;
+	cone_b.instantiate();
+	cone_b->set_attached_to(kusudama);
+	cone_b->set_radius(Math::PI / 8);
+	cone_b->set_control_point(Vector3(1, 0, 1).normalized());
+	kusudama->add_open_cone(cone_b);
+
+	// Enough directions to take the parallel path.
+	PackedVector3Array directions;
+	const int32_t ring_count = 64;
+	const int32_t segment_count = 64;
+	for (int32_t ring_i = 0; ring_i < ring_count; ring_i++) {
+		real_t polar = Math::PI * (ring_i + 0.5) / ring_count;
+		for (int32_t segment_i = 0; segment_i < segment_count; segment_i++) {
+			real_t azimuth = Math::TAU * segment_i / segment_count;
+			directions.push_back(Vector3(Math::sin(polar) * Math::cos(azimuth), Math::sin(polar) * Math::sin(azimuth), Math::cos(polar)));
+		}
+	}
+
+	PackedByteArray in_bounds;
+	PackedVector3Array limited_points;
+	kusudama->get_local_points_in_limits(directions, in_bounds, limited_points);
+	REQUIRE(in_bounds.size() == directions.size());
+	REQUIRE(limited_points.size() == directions.size());
+
+	int32_t inside_count = 0;
+	for (int32_t point_i = 0; point_i < directions.size(); point_i++) {
+		Vector<double> bounds;
+		bounds.resize(2);
+		bounds.write[0] = -1;
+		bounds.write[1] = 0;
+		Vector3 expected = kusudama->get_local_point_in_limits(directions[point_i], &bounds);
+		CHECK(limited_points[point_i].is_equal_approx(expected));
+		CHECK((in_bounds[point_i] == 1) == (bounds[0] >= 0));
+		inside_count += in_bounds[point_i];
+	}
+	CHECK(inside_count > 0);
+	CHECK(inside_count < directions.size());
+
+	Dictionary result = kusudama->call("get_local_points_in_limits", directions);
+	CHECK(PackedByteArray(result["in_bounds"]) == in_bounds);
+	CHECK(PackedVector3Array(result["points"]).size() == directions.size());
+}
 } // namespace TestIKKusudama3D
@@ -0,0 +1,210 @@
+/**************************************************************************/
+/*  test_ik_kusudama_fitter_3d.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_kusudama_fitter_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/math/random_pcg.h"
+
+namespace TestIKKusudamaFitter3D {
+
+using namespace TestManyBoneIK3DHelpers;
+
+// Two bones: bone 0 swings around two separate directions, bone 1 stays near rest.
+static PackedFloat32Array make_fitter_samples(int32_t p_frame_count, Vector<Vector3> &r_directions, Vector<real_t> &r_twists) {
+	RandomPCG rng(7);
+	const Vector3 up = Vector3(0, 1, 0);
+	const Vector3 centers[2] = { Vector3(0.5, 1, 0).normalized(), Vector3(-0.3, 1, 0.8).normalized() };
+	PackedFloat32Array rotations;
+	rotations.resize(p_frame_count * 2 * 4);
+	float *w = rotations.ptrw();
+	for (int32_t frame_i = 0; frame_i < p_frame_count; frame_i++) {
+		Vector3 jitter = Vector3(rng.randf() - 0.5f, rng.randf() - 0.5f, rng.randf() - 0.5f) * 0.3f;
+		Vector3 direction = (centers[frame_i % 2] + jitter).normalized();
+		real_t twist = -0.3f + 0.8f * rng.randf();
+		Quaternion rotation = Quaternion(up, direction) * Quaternion(up, twist);
+		r_directions.push_back(direction);
+		r_twists.push_back(twist);
+		*w++ = rotation.x;
+		*w++ = rotation.y;
+		*w++ = rotation.z;
+		*w++ = rotation.w;
+		Quaternion rest = Quaternion(Vector3(1, 0, 0), 0.05f * (rng.randf() - 0.5f));
+		*w++ = rest.x;
+		*w++ = rest.y;
+		*w++ = rest.z;
+		*w++ = rest.w;
+	}
+	return rotations;
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudamaFitter3D] Fitted cones and twist cover every sample") {
+	Vector<Vector3> directions;
+	Vector<real_t> twists;
+	PackedFloat32Array rotations = make_fitter_samples(4096, directions, twists);
+
+	Ref<IKKusudamaFitter3D> fitter;
+	fitter.instantiate();
+	fitter->set_max_open_cones(3);
+	fitter->begin(2);
+	fitter->accumulate(rotations);
+
+	CHECK(fitter->get_sample_count(0) == 4096);
+	CHECK(fitter->get_sample_count(1) == 4096);
+	const int32_t cone_count = fitter->get_open_cone_count(0);
+	CHECK(cone_count >= 2);
+	CHECK(cone_count <= 3);
+	CHECK(fitter->get_open_cone_count(1) == 1);
+
+	const Vector2 twist = fitter->get_twist(0);
+	for (int32_t sample_i = 0; sample_i < directions.size(); sample_i++) {
+		bool covered = false;
+		for (int32_t cone_i = 0; cone_i < cone_count; cone_i++) {
+			real_t cosine = fitter->get_open_cone_center(0, cone_i).dot(directions[sample_i]);
+			if (cosine >= Math::cos(fitter->get_open_cone_radius(0, cone_i)) - 1e-4) {
+				covered = true;
+				break;
+			}
+		}
+		CHECK_MESSAGE(covered, vformat("Sample %d is outside every fitted cone.", sample_i));
+		real_t offset = Math::wrapf(twists[sample_i] - twist.x, real_t(-1e-4), real_t(Math::TAU - 1e-4));
+		CHECK(offset <= twist.y + 1e-4);
+	}
+	CHECK(twist.y == doctest::Approx(0.8).epsilon(0.05));
+
+	PackedVector3Array points;
+	for (const Vector3 &direction : directions) {
+		points.push_back(direction);
+	}
+	PackedByteArray in_bounds;
+	PackedVector3Array limited_points;
+	fitter->create_kusudama(0)->get_local_points_in_limits(points, in_bounds, limited_points);
+	int32_t inside_count = 0;
+	for (int32_t point_i = 0; point_i < in_bounds.size(); point_i++) {
+		inside_count += in_bounds[point_i];
+	}
+	CHECK(inside_count == points.size());
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKKusudamaFitter3D] Streaming in chunks matches a single block") {
+	Vector<Vector3> directions;
+	Vector<real_t> twists;
+	PackedFloat32Array rotations = make_fitter_samples(2000, directions, twists);
+
+	Ref<IKKusudamaFitter3D> whole;
+	whole.instantiate();
+	whole->begin(2);
+	whole->accumulate(rotations);
+
+	Ref<IKKusudamaFitter3D> chunked;
+	chunked.instantiate();
+	chunked->begin(2);
+	const int32_t frame_floats = 2 * 4;
+	for (int32_t frame_begin = 0; frame_begin < 2000; frame_begin += 300) {
+		int32_t frame_end = MIN(frame_begin + 300, 2000);
+		chunked->accumulate(rotations.slice(frame_begin * frame_floats, frame_end * frame_floats));
+	}
+
+	for (int32_t bone_i = 0; bone_i < 2; bone_i++) {
+		REQUIRE(whole->get_open_cone_count(bone_i) == chunked->get_open_cone_count(bone_i));
+		for (int32_t cone_i = 0; cone_i < whole->get_open_cone_count(bone_i); cone_i++) {
+			CHECK(whole->get_open_cone_center(bone_i, cone_i).is_equal_approx(chunked->get_open_cone_center(bone_i, cone_i)));
+			CHECK(whole->get_open_cone_radius(bone_i, cone_i) == doctest::Approx(chunked->get_open_cone_radius(bone_i, cone_i)));
+		}
+		CHECK(whole->get_twist(bone_i).is_equal_approx(chunked->get_twist(bone_i)));
+	}
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKKusudamaFitter3D] Applied constraints hold the sampled poses in the solver") {
+	IKRig rig;
+	rig.scene = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(rig.scene);
+	rig.skeleton = memnew(Skeleton3D);
+	rig.scene->add_child(rig.skeleton);
+	const BoneId root = add_bone(rig, "root", -1, Vector3());
+	const BoneId upper = add_bone(rig, "upper", root, Vector3(0, 0.3, 0));
+	// The child sits well off the upper bone's Y axis, so the solver limits a different direction than a fit along Y.
+	const BoneId lower = add_bone(rig, "lower", upper, Vector3(0.2, 0.2, 0));
+	rig.skeleton->reset_bone_poses();
+	rig.ik = memnew(EWBIK3D);
+	rig.skeleton->add_child(rig.ik);
+	add_pin(rig, "root", Transform3D());
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	add_pin(rig, "lower", Transform3D(Basis(), Vector3(0.2, 0.5, 0)));
+	solve_frame(rig);
+
+	// The upper bone swings about X and twists a little about its own axis; the others stay at rest.
+	RandomPCG rng(11);
+	const int32_t frame_count = 512;
+	PackedFloat32Array rotations;
+	rotations.resize(frame_count * 3 * 4);
+	float *w = rotations.ptrw();
+	for (int32_t frame_i = 0; frame_i < frame_count; frame_i++) {
+		const Quaternion swing = Quaternion(Vector3(1, 0, 0), 0.6f + 0.3f * rng.randf());
+		const Quaternion samples[3] = { Quaternion(), swing * Quaternion(Vector3(0, 1, 0), 0.2f * (rng.randf() - 0.5f)), Quaternion() };
+		for (const Quaternion &sample : samples) {
+			*w++ = sample.x;
+			*w++ = sample.y;
+			*w++ = sample.z;
+			*w++ = sample.w;
+		}
+	}
+	Ref<IKKusudamaFitter3D> fitter;
+	fitter.instantiate();
+	fitter->set_cone_margin(0.05f);
+	fitter->begin_for(rig.ik);
+	fitter->accumulate(rotations);
+	fitter->apply(rig.ik);
+	REQUIRE(rig.ik->find_constraint("upper") != -1);
+
+	// A sampled pose held by its pins is not pushed out by its own constraint.
+	const Quaternion sampled = Quaternion(Vector3(1, 0, 0), 0.75f);
+	rig.skeleton->set_bone_pose_rotation(upper, sampled);
+	rig.ik->set_pin_target_transform(1, rig.skeleton->get_bone_global_pose(lower));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(rig.skeleton->get_bone_pose_rotation(upper).angle_to(sampled) < 0.02);
+
+	// Away from the samples, the constraint wins over the pin.
+	const Quaternion unsampled = Quaternion(Vector3(1, 0, 0), -0.75f);
+	rig.skeleton->set_bone_pose_rotation(upper, unsampled);
+	rig.ik->set_pin_target_transform(1, rig.skeleton->get_bone_global_pose(lower));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(rig.skeleton->get_bone_pose_rotation(upper).angle_to(unsampled) > 0.5);
+
+	free_rig(rig);
+}
+
+} // namespace TestIKKusudamaFitter3D
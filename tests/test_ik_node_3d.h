@@ -103,4 +103,23 @@ TEST_CASE("[Modules][IKNode3D] Test local transform calculation") {
 
 	CHECK(node->get_transform() == expected_local_transform);
 }
+TEST_CASE("[Modules][IKNode3D] Deferred propagation of local transforms") {
+	Ref<IKNode3D> root;
+	root.instantiate();
+	Ref<IKNode3D> child;
+	child.instantiate();
+	Ref<IKNode3D> grandchild;
+	grandchild.instantiate();
+	child->set_parent(root);
+	grandchild->set_parent(child);
+	grandchild->set_transform(Transform3D(Basis(), Vector3(0, 1, 0)));
+	CHECK(grandchild->get_global_transform().origin == Vector3(0, 1, 0));
+
+	// Both writes skip propagation, so the cached global is stale until the root propagates once.
+	root->set_transform(Transform3D(Basis(), Vector3(1, 0, 0)), false);
+	child->set_transform(Transform3D(Basis(Vector3(0, 0, 1), Math::PI / 2), Vector3()), false);
+	CHECK(grandchild->get_global_transform().origin == Vector3(0, 1, 0));
+	root->_propagate_transform_changed();
+	CHECK(grandchild->get_global_transform().origin.is_equal_approx(Vector3(0, 0, 0)));
+}
 } // namespace TestIKNode3D
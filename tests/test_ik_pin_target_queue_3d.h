@@ -0,0 +1,89 @@
+/**************************************************************************/
+/*  test_ik_pin_target_queue_3d.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_pin_target_queue_3d.h"
+#include "tests/test_macros.h"
+
+#include "core/os/thread.h"
+
+namespace TestIKPinTargetQueue3D {
+
+struct QueueProducer {
+	IKPinTargetQueue3D *queue = nullptr;
+	int32_t sample_count = 0;
+};
+
+static void push_numbered_samples(void *p_userdata) {
+	QueueProducer *producer = static_cast<QueueProducer *>(p_userdata);
+	for (int32_t sample_i = 0; sample_i < producer->sample_count;) {
+		IKPinTargetSample3D sample;
+		sample.pin_index = sample_i;
+		sample.timestamp = sample_i;
+		if (producer->queue->push(sample)) {
+			sample_i++;
+		}
+	}
+}
+
+TEST_CASE("[Modules][ManyBoneIK][IKPinTargetQueue3D] Samples cross threads in order") {
+	IKPinTargetQueue3D queue;
+	queue.set_capacity(60);
+	CHECK(queue.get_capacity() == 64);
+
+	QueueProducer producer;
+	producer.queue = &queue;
+	producer.sample_count = 20000;
+	Thread thread;
+	thread.start(push_numbered_samples, &producer);
+	IKPinTargetSample3D samples[16];
+	int32_t expected = 0;
+	bool in_order = true;
+	while (expected < producer.sample_count) {
+		const uint32_t count = queue.pop(samples, 16);
+		for (uint32_t sample_i = 0; sample_i < count; sample_i++) {
+			in_order = in_order && samples[sample_i].pin_index == expected;
+			expected++;
+		}
+	}
+	thread.wait_to_finish();
+	CHECK(in_order);
+	CHECK(queue.pop(samples, 16) == 0);
+
+	// A full ring rejects samples until the consumer catches up.
+	for (uint32_t sample_i = 0; sample_i < queue.get_capacity(); sample_i++) {
+		CHECK(queue.push(IKPinTargetSample3D()));
+	}
+	CHECK_FALSE(queue.push(IKPinTargetSample3D()));
+	CHECK(queue.pop(samples, 1) == 1);
+	CHECK(queue.push(IKPinTargetSample3D()));
+}
+
+} // namespace TestIKPinTargetQueue3D
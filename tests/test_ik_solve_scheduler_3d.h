@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  test_ik_solve_scheduler_3d.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_solve_scheduler_3d.h"
+#include "modules/many_bone_ik/src/many_bone_ik_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/config/engine.h"
+
+namespace TestIKSolveScheduler3D {
+
+using namespace TestManyBoneIK3DHelpers;
+
+TEST_CASE("[Modules][ManyBoneIK][IKSolveScheduler3D] Instances are spread evenly over the phases") {
+	Ref<IKSolveScheduler3D> scheduler;
+	scheduler.instantiate();
+	scheduler->set_period(3);
+	EWBIK3D *instances[7];
+	for (EWBIK3D *&instance : instances) {
+		instance = memnew(EWBIK3D);
+		instance->set_solve_scheduler(scheduler);
+	}
+	CHECK(scheduler->get_instance_count() == 7);
+
+	// Each frame solves the instances of one phase: three, two and two of the seven.
+	int32_t solves_per_frame[3] = { 0, 0, 0 };
+	for (uint64_t frame = 0; frame < 3; frame++) {
+		for (EWBIK3D *instance : instances) {
+			solves_per_frame[frame] += scheduler->is_solve_frame(instance, frame) ? 1 : 0;
+		}
+	}
+	CHECK(solves_per_frame[0] + solves_per_frame[1] + solves_per_frame[2] == 7);
+	for (int32_t solves : solves_per_frame) {
+		CHECK(solves >= 2);
+		CHECK(solves <= 3);
+	}
+
+	// A priority instance solves every frame and leaves its phase to the others.
+	scheduler->set_instance_priority(instances[0], true);
+	CHECK(scheduler->get_instance_phase(instances[0]) == -1);
+	for (uint64_t frame = 0; frame < 3; frame++) {
+		CHECK(scheduler->is_solve_frame(instances[0], frame));
+	}
+	scheduler->set_instance_priority(instances[0], false);
+	CHECK(scheduler->get_instance_phase(instances[0]) >= 0);
+
+	// A new period spreads everyone again.
+	scheduler->set_period(7);
+	for (uint64_t frame = 0; frame < 7; frame++) {
+		int32_t solves = 0;
+		for (EWBIK3D *instance : instances) {
+			solves += scheduler->is_solve_frame(instance, frame) ? 1 : 0;
+		}
+		CHECK(solves == 1);
+	}
+
+	for (EWBIK3D *instance : instances) {
+		memdelete(instance);
+	}
+	CHECK(scheduler->get_instance_count() == 0);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKSolveScheduler3D] Skipped frames hold the newest solve") {
+	Ref<IKSolveScheduler3D> scheduler;
+	scheduler.instantiate();
+	scheduler->set_period(2);
+	IKRig rigs[2] = { create_chain_rig(4, 0.1), create_chain_rig(4, 0.1) };
+	for (IKRig &rig : rigs) {
+		add_pin(rig, "root", Transform3D());
+		rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+		add_pin(rig, "bone_3", Transform3D(Basis(), Vector3(0.2, 0.3, 0.0)));
+		rig.ik->set_solve_scheduler(scheduler);
+	}
+	REQUIRE(scheduler->get_instance_phase(rigs[0].ik) != scheduler->get_instance_phase(rigs[1].ik));
+
+	// The frame counter does not advance here, so one rig solves on every call and the other only once, to have a pose to hold.
+	const uint64_t frame = Engine::get_singleton()->get_process_frames();
+	for (int32_t frame_i = 0; frame_i < 4; frame_i++) {
+		for (IKRig &rig : rigs) {
+			solve_frame(rig);
+		}
+	}
+	for (IKRig &rig : rigs) {
+		const bool in_phase = scheduler->is_solve_frame(rig.ik, frame);
+		CHECK(rig.ik->get_solved_pose_version() == (in_phase ? 4 : 1));
+	}
+
+	// Priority overrides the phase.
+	IKRig &skipped = scheduler->is_solve_frame(rigs[0].ik, frame) ? rigs[1] : rigs[0];
+	const Vector3 held = get_bone_origin(skipped, "bone_3");
+	solve_frame(skipped);
+	CHECK(get_bone_origin(skipped, "bone_3").is_equal_approx(held));
+	scheduler->set_instance_priority(skipped.ik, true);
+	solve_frame(skipped);
+	CHECK(skipped.ik->get_solved_pose_version() == 2);
+
+	for (IKRig &rig : rigs) {
+		free_rig(rig);
+	}
+}
+
+} // namespace TestIKSolveScheduler3D
@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  test_ik_solver_backend_3d.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_bone_segment_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/os/os.h"
+
+namespace TestIKSolverBackend3D {
+
+using namespace TestManyBoneIK3DHelpers;
+
+// Solves a 12-bone chain toward a reachable target and returns the tip's remaining distance to it.
+// The time spent on every frame after the first, which builds the segments, goes to r_usec when given.
+static real_t solve_chain(EWBIK3D::SolverBackend p_backend, int32_t p_frames, uint64_t *r_usec = nullptr) {
+	const int32_t bone_count = 12;
+	IKRig rig = create_chain_rig(bone_count, 0.1);
+	add_pin(rig, "root", Transform3D());
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	const Vector3 target = Vector3(0.5, 0.7, 0.3);
+	add_pin(rig, vformat("bone_%d", bone_count - 1), Transform3D(Basis(), target));
+	rig.ik->set_pin_direction_priorities(1, Vector3());
+	rig.ik->set_solver_backend(p_backend);
+
+	solve_frame(rig);
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int32_t frame_i = 1; frame_i < p_frames; frame_i++) {
+		solve_frame(rig);
+	}
+	if (r_usec) {
+		*r_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	}
+	const real_t distance = get_bone_origin(rig, vformat("bone_%d", bone_count - 1)).distance_to(target);
+	free_rig(rig);
+	return distance;
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKSolverBackend3D] Segments pick up the solver backend and its overrides") {
+	IKRig rig = create_chain_rig(4, 0.1);
+	add_pin(rig, "root", Transform3D());
+	add_pin(rig, "bone_3", Transform3D(Basis(), Vector3(0.1, 0.3, 0.1)));
+	rig.ik->set_solver_backend(EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES);
+	rig.ik->set_segment_solver_backend("bone_0", EWBIK3D::SOLVER_BACKEND_FABRIK);
+	solve_frame(rig);
+
+	Vector<Ref<IKBoneSegment3D>> roots = rig.ik->get_segmented_skeletons();
+	REQUIRE(roots.size() == 1);
+	CHECK(roots[0]->get_solver_backend() == EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES);
+	REQUIRE(roots[0]->get_child_segments().size() == 1);
+	CHECK(roots[0]->get_child_segments()[0]->get_solver_backend() == EWBIK3D::SOLVER_BACKEND_FABRIK);
+
+	rig.ik->clear_segment_solver_backend("bone_0");
+	CHECK(rig.ik->get_segment_solver_backend("bone_0") == EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES);
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][IKSolverBackend3D] Every backend moves a chain toward its pin") {
+	const real_t start_distance = Vector3(0.5, 0.7, 0.3).distance_to(Vector3(0.0, 1.2, 0.0));
+	for (int32_t backend_i = EWBIK3D::SOLVER_BACKEND_QCP; backend_i <= EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES; backend_i++) {
+		const real_t distance = solve_chain(EWBIK3D::SolverBackend(backend_i), 10);
+		CHECK(Math::is_finite(distance));
+		CHECK(distance < start_distance * 0.5);
+		if (backend_i == EWBIK3D::SOLVER_BACKEND_FABRIK) {
+			CHECK(distance < 1e-2);
+		}
+	}
+}
+
+// Timings are too noisy for the unit run; run with --no-skip to see them.
+TEST_CASE("[Benchmark][SceneTree][Modules][ManyBoneIK][IKSolverBackend3D] Backends side by side on a chain" * doctest::skip()) {
+	const char *names[] = { "QCP", "FABRIK", "Damped Least Squares" };
+	for (int32_t backend_i = EWBIK3D::SOLVER_BACKEND_QCP; backend_i <= EWBIK3D::SOLVER_BACKEND_DAMPED_LEAST_SQUARES; backend_i++) {
+		uint64_t usec = 0;
+		const real_t distance = solve_chain(EWBIK3D::SolverBackend(backend_i), 10, &usec);
+		MESSAGE(vformat("%s: %.5f from the target after 10 frames, %d usec for the last 9.", names[backend_i], distance, usec));
+		CHECK(Math::is_finite(distance));
+	}
+}
+
+} // namespace TestIKSolverBackend3D
@@ -0,0 +1,617 @@
+/**************************************************************************/
+/*  test_many_bone_ik_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/ik_bone_segment_3d.h"
+#include "modules/many_bone_ik/src/many_bone_ik_3d.h"
+#include "modules/many_bone_ik/tests/test_many_bone_ik_3d_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "scene/3d/camera_3d.h"
+
+namespace TestManyBoneIK3D {
+
+using namespace TestManyBoneIK3DHelpers;
+
+// A 6-bone chain with its root held in place and a pin on the tip that has no target node.
+static IKRig create_pinned_chain() {
+	IKRig rig = create_chain_rig(6, 0.1);
+	add_pin(rig, "root", Transform3D());
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	rig.ik->set_pin_count(2);
+	rig.ik->set_pin_bone_name(1, "bone_5");
+	rig.ik->set_pin_direction_priorities(1, Vector3());
+	return rig;
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Pins follow target transforms without target nodes") {
+	IKRig rig = create_pinned_chain();
+	const Vector3 target = Vector3(0.25, 0.45, 0.1);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), target));
+	CHECK(rig.ik->is_pin_target_transform_enabled(1));
+	CHECK_FALSE(rig.ik->is_pin_target_transform_enabled(0));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(target) < 0.02);
+
+	// Moving the target does not rebuild the segments.
+	const Ref<IKBoneSegment3D> segments = rig.ik->get_segmented_skeletons()[0];
+	const Vector3 moved_target = Vector3(-0.2, 0.4, 0.2);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), moved_target));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(rig.ik->get_segmented_skeletons()[0] == segments);
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(moved_target) < 0.02);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] World space and bulk pin target transforms") {
+	IKRig rig = create_pinned_chain();
+	rig.skeleton->set_global_transform(Transform3D(Basis(Vector3(0, 1, 0), Math::PI / 2), Vector3(2, 0, 0)));
+	const Transform3D world_target = Transform3D(Basis(), Vector3(2.1, 0.4, -0.2));
+	rig.ik->set_pin_target_transform(1, world_target, EWBIK3D::PIN_TARGET_SPACE_WORLD);
+	const Transform3D skeleton_target = rig.skeleton->get_global_transform().affine_inverse() * world_target;
+	CHECK(rig.ik->get_pin_target_transform(1).is_equal_approx(skeleton_target));
+
+	// Twelve floats per pin: basis rows, each followed by an origin component.
+	PackedFloat32Array transforms;
+	const Transform3D targets[2] = {
+		Transform3D(),
+		Transform3D(Basis(Vector3(1, 0, 0), 0.5), Vector3(0.2, 0.3, 0.1)),
+	};
+	for (const Transform3D &transform : targets) {
+		for (int32_t row = 0; row < 3; row++) {
+			transforms.push_back(transform.basis.rows[row].x);
+			transforms.push_back(transform.basis.rows[row].y);
+			transforms.push_back(transform.basis.rows[row].z);
+			transforms.push_back(transform.origin[row]);
+		}
+	}
+	rig.ik->set_pin_target_transforms(transforms);
+	CHECK(rig.ik->is_pin_target_transform_enabled(0));
+	CHECK(rig.ik->get_pin_target_transform(1).is_equal_approx(targets[1]));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(targets[1].origin) < 0.02);
+
+	ERR_PRINT_OFF;
+	transforms.resize(13);
+	rig.ik->set_pin_target_transforms(transforms);
+	ERR_PRINT_ON;
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] World space pin targets hold still while the skeleton moves") {
+	IKRig rig = create_pinned_chain();
+	const Vector3 world_target = Vector3(0.2, 0.35, 0.1);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), world_target), EWBIK3D::PIN_TARGET_SPACE_WORLD);
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+
+	// The target is set once; moving the skeleton afterwards must not drag it along.
+	rig.skeleton->set_global_transform(Transform3D(Basis(), Vector3(0.05, 0, 0)));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	const Transform3D to_skeleton = rig.skeleton->get_global_transform().affine_inverse();
+	CHECK(rig.ik->get_pin_target_transform(1).origin.is_equal_approx(to_skeleton.xform(world_target)));
+	CHECK(rig.skeleton->get_global_transform().xform(get_bone_origin(rig, "bone_5")).distance_to(world_target) < 0.02);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Clearing a pin target transform returns to the target node") {
+	IKRig rig = create_chain_rig(6, 0.1);
+	add_pin(rig, "root", Transform3D());
+	rig.ik->set_pin_motion_propagation_factor(0, 0.0f);
+	const Vector3 node_target = Vector3(0.3, 0.4, 0.0);
+	add_pin(rig, "bone_5", Transform3D(Basis(), node_target));
+	rig.ik->set_pin_direction_priorities(1, Vector3());
+
+	const Vector3 transform_target = Vector3(-0.3, 0.4, 0.0);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), transform_target));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(transform_target) < 0.02);
+
+	rig.ik->clear_pin_target_transform(1);
+	CHECK_FALSE(rig.ik->is_pin_target_transform_enabled(1));
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(node_target) < 0.02);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Queued pin targets are drained at the next solve") {
+	IKRig rig = create_pinned_chain();
+	const double now = double(OS::get_singleton()->get_ticks_usec()) / 1000000.0;
+	CHECK(rig.ik->push_pin_target(1, Transform3D(Basis(), Vector3(0.3, 0.3, 0.0)), now - 0.2));
+	const Vector3 newest = Vector3(-0.2, 0.4, 0.1);
+	CHECK(rig.ik->push_pin_target(1, Transform3D(Basis(), newest), now - 0.1));
+	solve_frame(rig);
+	CHECK(rig.ik->is_pin_target_transform_enabled(1));
+	CHECK(rig.ik->get_pin_target_transform(1).origin.is_equal_approx(newest));
+
+	// Halfway between two samples ten seconds either side of the present. Clearing forgets the earlier history.
+	rig.ik->clear_pin_target_transform(1);
+	rig.ik->set_pin_target_interpolation_delay(10.0);
+	const double later = double(OS::get_singleton()->get_ticks_usec()) / 1000000.0;
+	rig.ik->push_pin_target(1, Transform3D(Basis(), Vector3(0.0, 0.2, 0.0)), later - 20.0);
+	rig.ik->push_pin_target(1, Transform3D(Basis(), Vector3(0.0, 0.6, 0.0)), later);
+	solve_frame(rig);
+	CHECK(rig.ik->get_pin_target_transform(1).origin.distance_to(Vector3(0.0, 0.4, 0.0)) < 1e-3);
+
+	// Samples for pins that do not exist are dropped when drained.
+	CHECK(rig.ik->push_pin_target(7, Transform3D(), later));
+	solve_frame(rig);
+	CHECK(rig.ik->get_pin_count() == 2);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Async solve applies the previous completed pose") {
+	IKRig rig = create_pinned_chain();
+	const Vector3 target = Vector3(0.25, 0.45, 0.1);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), target));
+	rig.ik->set_async_solve(true);
+
+	// The first frame only launches a solve, so nothing is written yet.
+	solve_frame(rig);
+	CHECK(rig.ik->is_async_solve_running());
+	CHECK(rig.ik->get_last_written_bone_count() == 0);
+
+	bool reached = false;
+	for (int32_t frame_i = 0; frame_i < 2000 && !reached; frame_i++) {
+		OS::get_singleton()->delay_usec(1000);
+		solve_frame(rig);
+		reached = get_bone_origin(rig, "bone_5").distance_to(target) < 0.02;
+	}
+	CHECK(reached);
+
+	// A rebuild cancels the running solve and starts over from an empty front buffer.
+	rig.ik->set_dirty();
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_written_bone_count() == 0);
+	CHECK(rig.ik->is_async_solve_running());
+
+	rig.ik->set_async_solve(false);
+	CHECK_FALSE(rig.ik->is_async_solve_running());
+	solve_frame(rig);
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(target) < 0.02);
+
+	free_rig(rig);
+}
+
+struct PoseReader {
+	const EWBIK3D *ik = nullptr;
+	LocalVector<Transform3D> transforms;
+	uint64_t version = 0;
+	bool read = false;
+};
+
+static void read_solved_pose(void *p_userdata) {
+	PoseReader *reader = static_cast<PoseReader *>(p_userdata);
+	reader->read = reader->ik->get_pose_snapshot().read(reader->transforms, &reader->version);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Solved pose snapshot is readable from other threads") {
+	IKRig rig = create_pinned_chain();
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), Vector3(0.25, 0.45, 0.1)));
+	CHECK(rig.ik->get_solved_pose().is_empty());
+	solve_frame(rig);
+	solve_frame(rig);
+	CHECK(rig.ik->get_solved_pose_version() == 2);
+
+	PoseReader reader;
+	reader.ik = rig.ik;
+	Thread thread;
+	thread.start(read_solved_pose, &reader);
+	thread.wait_to_finish();
+	REQUIRE(reader.read);
+	CHECK(reader.version == 2);
+	REQUIRE(int32_t(reader.transforms.size()) == rig.skeleton->get_bone_count() * 2);
+	for (int32_t bone_i = 0; bone_i < rig.skeleton->get_bone_count(); bone_i++) {
+		CHECK(reader.transforms[bone_i * 2].is_equal_approx(rig.skeleton->get_bone_pose(bone_i)));
+		CHECK(reader.transforms[bone_i * 2 + 1].is_equal_approx(rig.skeleton->get_bone_global_pose(bone_i)));
+	}
+	const PackedFloat32Array pose = rig.ik->get_solved_pose();
+	CHECK(pose.size() == rig.skeleton->get_bone_count() * 24);
+
+	// A rebuild resizes the slots, and the solve right after it publishes again.
+	rig.ik->set_dirty();
+	solve_frame(rig);
+	CHECK(rig.ik->get_solved_pose_version() == 3);
+	CHECK(rig.ik->get_solved_pose().size() == pose.size());
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Fixed solve rate interpolates between solves") {
+	IKRig rig = create_pinned_chain();
+	const Vector3 target = Vector3(0.25, 0.45, 0.1);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), target));
+	rig.ik->set_solve_rate(30.0f);
+
+	// Half a second at 120 frames per second solves about 15 times, not 60.
+	for (int32_t frame_i = 0; frame_i < 60; frame_i++) {
+		solve_frame(rig, 1.0 / 120.0);
+	}
+	const int64_t solves = rig.ik->get_solved_pose_version();
+	CHECK(solves >= 14);
+	CHECK(solves <= 16);
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(target) < 0.02);
+
+	// The frames between two solves keep moving the tip, instead of holding it until the next solve.
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), Vector3(-0.25, 0.45, 0.1)));
+	int64_t version = rig.ik->get_solved_pose_version();
+	Vector3 tip = get_bone_origin(rig, "bone_5");
+	int32_t moves = 0;
+	while (rig.ik->get_solved_pose_version() < version + 2) {
+		solve_frame(rig, 1.0 / 120.0);
+		moves += get_bone_origin(rig, "bone_5").is_equal_approx(tip) ? 0 : 1;
+		tip = get_bone_origin(rig, "bone_5");
+	}
+	CHECK(moves > 2);
+
+	// A target that moves faster than the threshold is solved every frame.
+	rig.ik->set_fast_target_speed(0.5f);
+	version = rig.ik->get_solved_pose_version();
+	for (int32_t frame_i = 0; frame_i < 8; frame_i++) {
+		rig.ik->set_pin_target_transform(1, Transform3D(Basis(), Vector3(frame_i % 2 ? 0.25 : -0.25, 0.45, 0.1)));
+		solve_frame(rig, 1.0 / 120.0);
+	}
+	CHECK(rig.ik->get_solved_pose_version() - version >= 6);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] LOD tiers follow the camera with hysteresis") {
+	IKRig rig = create_pinned_chain();
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), Vector3(0.25, 0.45, 0.1)));
+	rig.ik->set_pin_count(3);
+	rig.ik->set_pin_bone_name(2, "bone_2");
+	rig.ik->set_pin_weight(2, 0.1f);
+	rig.ik->set_pin_target_transform(2, Transform3D(Basis(), Vector3(0.1, 0.2, 0.0)));
+	rig.ik->set_lod_freeze_depth(0);
+	Camera3D *camera = memnew(Camera3D);
+	rig.scene->add_child(camera);
+	camera->make_current();
+	PackedFloat32Array thresholds;
+	thresholds.push_back(5.0f);
+	thresholds.push_back(10.0f);
+	rig.ik->set_lod_thresholds(thresholds);
+
+	const auto place_camera = [&](real_t p_distance) {
+		camera->set_global_position(rig.skeleton->get_global_position() + Vector3(0, 0, p_distance));
+		solve_frame(rig);
+		solve_frame(rig);
+	};
+	place_camera(2.0);
+	CHECK(rig.ik->get_lod_tier() == 0);
+	const int32_t bone_2 = rig.skeleton->find_bone("bone_2");
+	CHECK(rig.ik->get_segmented_skeletons()[0]->get_ik_bone(bone_2)->is_pinned());
+
+	// The low weight pin is skipped from tier 1 without a rebuild, and segments below the root one freeze from tier 2.
+	const Ref<IKBoneSegment3D> root_segment = rig.ik->get_segmented_skeletons()[0];
+	place_camera(20.0);
+	CHECK(rig.ik->get_lod_tier() == 2);
+	CHECK(rig.ik->get_segmented_skeletons()[0] == root_segment);
+	CHECK(root_segment->get_ik_bone(bone_2)->get_pin()->is_lod_skipped());
+	REQUIRE(root_segment->get_child_segments().size() > 0);
+	CHECK(root_segment->get_child_segments()[0]->is_frozen());
+	CHECK_FALSE(root_segment->is_frozen());
+
+	// Just inside a threshold is not far enough to switch back.
+	place_camera(9.5);
+	CHECK(rig.ik->get_lod_tier() == 2);
+	place_camera(8.0);
+	CHECK(rig.ik->get_lod_tier() == 1);
+	CHECK_FALSE(rig.ik->get_segmented_skeletons()[0]->get_child_segments()[0]->is_frozen());
+	place_camera(4.0);
+	CHECK(rig.ik->get_lod_tier() == 0);
+	CHECK(rig.ik->get_segmented_skeletons()[0] == root_segment);
+	CHECK_FALSE(root_segment->get_ik_bone(bone_2)->get_pin()->is_lod_skipped());
+
+	// Screen size shrinks with distance, so the same camera moves the other way through the tiers.
+	rig.ik->set_lod_metric(EWBIK3D::LOD_METRIC_SCREEN_SIZE);
+	thresholds.set(0, 0.2f);
+	thresholds.set(1, 0.05f);
+	rig.ik->set_lod_thresholds(thresholds);
+	place_camera(100.0);
+	CHECK(rig.ik->get_lod_tier() == 2);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Sleeps while targets and input pose hold still") {
+	IKRig rig = create_pinned_chain();
+	const Vector3 target = Vector3(0.25, 0.45, 0.1);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), target));
+	rig.ik->set_sleep_translation_threshold(1e-3f);
+	rig.ik->set_sleep_rotation_threshold(1e-3f);
+	for (int32_t frame_i = 0; frame_i < 40; frame_i++) {
+		solve_frame(rig);
+	}
+	// Once the solve settles its own output stops changing the input, and the rest of the frames sleep.
+	CHECK(rig.ik->is_sleeping());
+	CHECK(rig.ik->get_sleeping_frame_count() > 0);
+	CHECK(rig.ik->get_sleeping_frame_count() + rig.ik->get_solved_frame_count() == 40);
+	const Vector3 tip = get_bone_origin(rig, "bone_5");
+	CHECK(tip.distance_to(target) < 0.02);
+
+	// An animation putting the rest pose back every frame is undone by the cached result.
+	rig.ik->reset_frame_counts();
+	rig.skeleton->reset_bone_poses();
+	solve_frame(rig);
+	CHECK_FALSE(rig.ik->is_sleeping());
+	rig.skeleton->reset_bone_poses();
+	solve_frame(rig);
+	CHECK(rig.ik->is_sleeping());
+	CHECK(get_bone_origin(rig, "bone_5").distance_to(target) < 0.02);
+
+	// A moved target wakes it up.
+	const Vector3 moved_target = Vector3(-0.2, 0.4, 0.2);
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(), moved_target));
+	solve_frame(rig);
+	CHECK_FALSE(rig.ik->is_sleeping());
+	CHECK(rig.ik->get_solved_frame_count() == 2);
+
+	// Turning the target in place wakes it too: the rotation threshold is an angle, not a distance.
+	for (int32_t frame_i = 0; frame_i < 40; frame_i++) {
+		solve_frame(rig);
+	}
+	REQUIRE(rig.ik->is_sleeping());
+	rig.ik->set_pin_target_transform(1, Transform3D(Basis(Vector3(0, 1, 0), 0.01), moved_target));
+	solve_frame(rig);
+	CHECK_FALSE(rig.ik->is_sleeping());
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Partial solves skip branches without moved pins") {
+	IKRig rig = create_leg_rig();
+	add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+	add_pin(rig, "spine", Transform3D(Basis(), Vector3(0.05, 1.3, 0)));
+	Node3D *foot_target = add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.1, 0.2, 0.1)));
+	rig.ik->set_partial_solve(true);
+	solve_frame(rig);
+	const int32_t all_segments = rig.ik->get_last_solved_segment_count();
+	CHECK(all_segments >= 3);
+
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 0);
+
+	// The pins do not propagate their motion, so the foot only wakes the leg.
+	const Vector3 spine = get_bone_origin(rig, "spine");
+	foot_target->set_global_position(rig.skeleton->get_global_transform().xform(Vector3(0.15, 0.25, 0.15)));
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 1);
+	CHECK(get_bone_origin(rig, "spine").is_equal_approx(spine));
+
+	rig.ik->set_partial_solve(false);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == all_segments);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Partial solves carry the branches below a solved segment") {
+	IKRig rig = create_leg_rig();
+	Node3D *hips_target = add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+	const Vector3 foot_target = Vector3(0.1, 0.2, 0.1);
+	add_pin(rig, "foot", Transform3D(Basis(), foot_target));
+	rig.ik->set_partial_solve(true);
+	solve_frame(rig);
+	const int32_t all_segments = rig.ik->get_last_solved_segment_count();
+	const real_t foot_distance = get_bone_origin(rig, "foot").distance_to(foot_target);
+
+	// Only the hips tracker moves, but the leg below it has to reach for its unchanged target again.
+	hips_target->set_global_position(rig.skeleton->get_global_transform().xform(Vector3(0.05, 0.95, 0)));
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == all_segments);
+	CHECK(get_bone_origin(rig, "hips").distance_to(Vector3(0, 1, 0)) > 0.03);
+	CHECK(get_bone_origin(rig, "foot").distance_to(foot_target) <= foot_distance + 0.01);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Only pins whose target moved wake a partial solve") {
+	IKRig rig = create_leg_rig();
+	add_pin(rig, "hips", Transform3D(Basis(), Vector3(0, 1, 0)));
+	add_pin(rig, "spine", Transform3D(Basis(), Vector3(0.05, 1.3, 0)));
+	add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.1, 0.2, 0.1)));
+	rig.ik->set_partial_solve(true);
+	solve_frame(rig);
+	const int32_t all_segments = rig.ik->get_last_solved_segment_count();
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 0);
+
+	// A pushed target queues its pin without touching the target nodes.
+	const int32_t foot_pin = rig.ik->find_pin("foot");
+	rig.ik->set_pin_target_transform(foot_pin, Transform3D(Basis(), Vector3(0.15, 0.25, 0.1)), EWBIK3D::PIN_TARGET_SPACE_SKELETON);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 1);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 0);
+
+	// Pushing the same target again does not count as a move.
+	rig.ik->set_pin_target_transform(foot_pin, Transform3D(Basis(), Vector3(0.15, 0.25, 0.1)), EWBIK3D::PIN_TARGET_SPACE_SKELETON);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() == 0);
+
+	// Moving the skeleton moves every node target relative to it.
+	rig.skeleton->set_global_position(Vector3(1, 0, 0));
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_solved_segment_count() >= 2);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Root and tip bones limit what is built") {
+	IKRig rig = create_leg_rig();
+	add_pin(rig, "foot", Transform3D(Basis(), Vector3(0.3, 0.2, 0.1)));
+	add_pin(rig, "spine", Transform3D(Basis(), Vector3(0, 1.3, 0)));
+	solve_frame(rig);
+	CHECK(rig.ik->get_bone_list().size() == 5);
+
+	rig.ik->set_root_bone("thigh");
+	solve_frame(rig);
+	CHECK(rig.ik->get_bone_list().size() == 3);
+	CHECK_FALSE(rig.ik->is_bone_in_scope(rig.skeleton->find_bone("hips")));
+	CHECK_FALSE(rig.ik->is_bone_in_scope(rig.skeleton->find_bone("spine")));
+	CHECK(rig.ik->is_bone_in_scope(rig.skeleton->find_bone("foot")));
+
+	// The foot pin is below the tip, so only the solver's root is left.
+	rig.ik->set_tip_bone("shin");
+	solve_frame(rig);
+	CHECK(rig.ik->get_bone_list().size() == 1);
+	CHECK_FALSE(rig.ik->is_bone_in_scope(rig.skeleton->find_bone("foot")));
+
+	// Bones outside the scope, above and below it, still show up in the solved pose.
+	LocalVector<Transform3D> transforms;
+	REQUIRE(rig.ik->get_pose_snapshot().read(transforms));
+	REQUIRE(int32_t(transforms.size()) == rig.skeleton->get_bone_count() * 2);
+	for (int32_t bone_i = 0; bone_i < rig.skeleton->get_bone_count(); bone_i++) {
+		CHECK(transforms[bone_i * 2].is_equal_approx(rig.skeleton->get_bone_pose(bone_i)));
+		CHECK(transforms[bone_i * 2 + 1].is_equal_approx(rig.skeleton->get_bone_global_pose(bone_i)));
+	}
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] A pin root bone keeps the bones above it still") {
+	IKRig rig = create_leg_rig();
+	// Within reach of the shin alone, away from where the foot rests.
+	const Vector3 knee = get_bone_origin(rig, "shin");
+	const Vector3 target = knee + Vector3(0.3, -0.33, 0.0).normalized() * 0.45;
+	add_pin(rig, "foot", Transform3D(Basis(), target));
+	rig.ik->set_pin_root_bone(0, "shin");
+	const real_t initial_distance = get_bone_origin(rig, "foot").distance_to(target);
+	for (int32_t frame_i = 0; frame_i < 10; frame_i++) {
+		solve_frame(rig);
+	}
+	CHECK(rig.ik->get_bone_list().size() == 2);
+	CHECK_FALSE(rig.ik->is_bone_in_scope(rig.skeleton->find_bone("hips")));
+	CHECK(get_bone_origin(rig, "shin").is_equal_approx(knee));
+	CHECK(get_bone_origin(rig, "foot").distance_to(target) < initial_distance * 0.5);
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Bulk pose write-back and read-back agree with the skeleton") {
+	IKRig rig = create_chain_rig(8, 0.1);
+	add_pin(rig, "bone_7", Transform3D(Basis(), Vector3(0.3, 0.5, 0.2)));
+	solve_frame(rig);
+	solve_frame(rig);
+
+	// modification_processed reads the written poses back, so both sides must hold the same local and global poses.
+	for (const Ref<IKBone3D> &bone : rig.ik->get_bone_list()) {
+		const BoneId bone_id = bone->get_bone_id();
+		if (bone_id == -1) {
+			continue;
+		}
+		const Transform3D skeleton_pose = rig.skeleton->get_bone_pose(bone_id);
+		CHECK(bone->get_pose().origin.is_equal_approx(skeleton_pose.origin));
+		CHECK(bone->get_pose().basis.get_rotation_quaternion().angle_to(skeleton_pose.basis.get_rotation_quaternion()) < 1e-4);
+		CHECK(bone->get_global_pose().origin.distance_to(rig.skeleton->get_bone_global_pose(bone_id).origin) < 1e-4);
+	}
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Bones within the pose write epsilon are not written back") {
+	IKRig rig = create_chain_rig(8, 0.1);
+	Node3D *target = add_pin(rig, "bone_7", Transform3D(Basis(), Vector3(0.3, 0.5, 0.2)));
+	solve_frame(rig);
+	// The virtual root bone is never written, so every skeleton bone is.
+	CHECK(rig.ik->get_last_written_bone_count() == rig.skeleton->get_bone_count());
+
+	// Past the solve's own movement, no bone is worth writing and the skeleton keeps its pose.
+	Vector<Transform3D> poses_before;
+	for (int32_t bone_i = 0; bone_i < rig.skeleton->get_bone_count(); bone_i++) {
+		poses_before.push_back(rig.skeleton->get_bone_pose(bone_i));
+	}
+	rig.ik->set_pose_write_translation_epsilon(10.0);
+	rig.ik->set_pose_write_rotation_epsilon(Math::PI);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_written_bone_count() == 0);
+	for (int32_t bone_i = 0; bone_i < rig.skeleton->get_bone_count(); bone_i++) {
+		CHECK(rig.skeleton->get_bone_pose(bone_i).is_equal_approx(poses_before[bone_i]));
+	}
+
+	// Moving the target far enough writes at least the bones that follow it.
+	target->set_global_transform(rig.skeleton->get_global_transform() * Transform3D(Basis(), Vector3(-0.4, 0.3, -0.2)));
+	rig.ik->set_pose_write_translation_epsilon(1e-3);
+	rig.ik->set_pose_write_rotation_epsilon(1e-3);
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_written_bone_count() > 0);
+	CHECK(rig.ik->get_last_written_bone_count() <= rig.skeleton->get_bone_count());
+
+	free_rig(rig);
+}
+
+TEST_CASE("[SceneTree][Modules][ManyBoneIK][EWBIK3D] Bones override the pose write epsilons") {
+	IKRig rig = create_chain_rig(8, 0.1);
+	Node3D *target = add_pin(rig, "bone_7", Transform3D(Basis(), Vector3(0.3, 0.5, 0.2)));
+	solve_frame(rig);
+	rig.ik->set_pose_write_translation_epsilon(10.0);
+	rig.ik->set_pose_write_rotation_epsilon(Math::PI);
+	// Set through the property list, as a saved scene would.
+	rig.ik->set("pose_write_bone_count", 1);
+	rig.ik->set("bones/0/bone_name", StringName("bone_3"));
+	rig.ik->set("bones/0/pose_write_rotation_epsilon", 1e-4);
+	CHECK(rig.ik->get_pose_write_bone_name(0) == StringName("bone_3"));
+	CHECK(double(rig.ik->get("bones/0/pose_write_rotation_epsilon")) == doctest::Approx(1e-4));
+	// Left negative, the translation epsilon falls back to the modifier's.
+	CHECK(rig.ik->get_pose_write_bone_translation_epsilon(0) < 0.0);
+
+	// Only the overridden bone is tight enough to follow the moved target.
+	const BoneId bone_3 = rig.skeleton->find_bone("bone_3");
+	const Quaternion rotation_before = rig.skeleton->get_bone_pose_rotation(bone_3);
+	target->set_global_transform(rig.skeleton->get_global_transform() * Transform3D(Basis(), Vector3(-0.4, 0.3, -0.2)));
+	solve_frame(rig);
+	CHECK(rig.ik->get_last_written_bone_count() == 1);
+	CHECK_FALSE(rig.skeleton->get_bone_pose_rotation(bone_3).is_equal_approx(rotation_before));
+
+	free_rig(rig);
+}
+
+} // namespace TestManyBoneIK3D
@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*  test_many_bone_ik_3d_helpers.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+#include "modules/many_bone_ik/src/many_bone_ik_3d.h"
+#include "tests/test_macros.h"
+
+#include "scene/3d/node_3d.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+namespace TestManyBoneIK3DHelpers {
+
+// A skeleton with an EWBIK3D child and its pin targets, living in the SceneTree so targets resolve.
+struct IKRig {
+	Node3D *scene = nullptr;
+	Skeleton3D *skeleton = nullptr;
+	EWBIK3D *ik = nullptr;
+};
+
+inline BoneId add_bone(IKRig &r_rig, const String &p_name, BoneId p_parent, const Vector3 &p_offset) {
+	BoneId bone = r_rig.skeleton->add_bone(p_name);
+	r_rig.skeleton->set_bone_parent(bone, p_parent);
+	r_rig.skeleton->set_bone_rest(bone, Transform3D(Basis(), p_offset));
+	return bone;
+}
+
+// Hips with a spine and a leg of thigh, shin and foot. The knee is slightly bent so the leg has a bend plane.
+inline IKRig create_leg_rig() {
+	IKRig rig;
+	rig.scene = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(rig.scene);
+	rig.skeleton = memnew(Skeleton3D);
+	rig.scene->add_child(rig.skeleton);
+	BoneId hips = add_bone(rig, "hips", -1, Vector3(0, 1, 0));
+	add_bone(rig, "spine", hips, Vector3(0, 0.3, 0));
+	BoneId thigh = add_bone(rig, "thigh", hips, Vector3(0.1, 0, 0));
+	BoneId shin = add_bone(rig, "shin", thigh, Vector3(0, -0.45, 0.02));
+	add_bone(rig, "foot", shin, Vector3(0, -0.45, -0.02));
+	rig.skeleton->reset_bone_poses();
+	rig.ik = memnew(EWBIK3D);
+	rig.skeleton->add_child(rig.ik);
+	return rig;
+}
+
+// A root bone followed by a chain of p_bone_count bones named bone_0, bone_1 and so on, zigzagging slightly so no joint starts straight.
+inline IKRig create_chain_rig(int32_t p_bone_count, real_t p_bone_length) {
+	IKRig rig;
+	rig.scene = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(rig.scene);
+	rig.skeleton = memnew(Skeleton3D);
+	rig.scene->add_child(rig.skeleton);
+	BoneId parent = add_bone(rig, "root", -1, Vector3());
+	for (int32_t bone_i = 0; bone_i < p_bone_count; bone_i++) {
+		real_t zigzag = (bone_i % 2) ? 0.05f : -0.05f;
+		parent = add_bone(rig, vformat("bone_%d", bone_i), parent, Vector3(zigzag * p_bone_length, p_bone_length, 0));
+	}
+	rig.skeleton->reset_bone_poses();
+	rig.ik = memnew(EWBIK3D);
+	rig.skeleton->add_child(rig.ik);
+	return rig;
+}
+
+// Pins p_bone to a new target node placed at p_target in skeleton space, and returns the target.
+inline Node3D *add_pin(IKRig &r_rig, const String &p_bone, const Transform3D &p_target) {
+	Node3D *target = memnew(Node3D);
+	target->set_name(p_bone + "_target");
+	r_rig.scene->add_child(target);
+	target->set_global_transform(r_rig.skeleton->get_global_transform() * p_target);
+	int32_t pin_i = r_rig.ik->get_pin_count();
+	r_rig.ik->set_pin_count(pin_i + 1);
+	r_rig.ik->set_pin_bone_name(pin_i, p_bone);
+	r_rig.ik->set_pin_target_node_path(pin_i, r_rig.ik->get_path_to(target));
+	return target;
+}
+
+inline void solve_frame(IKRig &r_rig, double p_delta = 1.0 / 60.0) {
+	r_rig.ik->process_modification(p_delta);
+}
+
+inline Vector3 get_bone_origin(const IKRig &r_rig, const String &p_bone) {
+	return r_rig.skeleton->get_bone_global_pose(r_rig.skeleton->find_bone(p_bone)).origin;
+}
+
+inline void free_rig(IKRig &r_rig) {
+	memdelete(r_rig.scene);
+	r_rig = IKRig();
+}
+
+} // namespace TestManyBoneIK3DHelpers
@@ -343,4 +343,242 @@ TEST_CASE("[Modules][QCP] Advanced - Comprehensive Geometric Validation Suite")
 	CHECK((translation - expected_translation).length() < 1e-6);
 }
 
+// Brute force weighted mean squared deviation of the moved points after a rigid transform.
+static double measure_msd(const Quaternion &p_rotation, const Vector3 &p_translation, const PackedVector3Array &p_moved, const PackedVector3Array &p_target, const Vector<double> &p_weights) {
+	double deviation = 0.0;
+	double weight_sum = 0.0;
+	for (int i = 0; i < p_moved.size(); i++) {
+		deviation += p_weights[i] * (p_rotation.xform(p_moved[i]) + p_translation - p_target[i]).length_squared();
+		weight_sum += p_weights[i];
+	}
+	return deviation / weight_sum;
+}
+
+TEST_CASE("[Modules][QCP] Advanced - Residual From The Eigenvalue Matches The Measured Deviation") {
+	PackedVector3Array moved_points;
+	moved_points.push_back(Vector3(1, 0.2, 0));
+	moved_points.push_back(Vector3(0, 1.5, 0.3));
+	moved_points.push_back(Vector3(-0.4, 0, 1));
+	moved_points.push_back(Vector3(0.7, -0.8, 0.2));
+	Vector<double> weights;
+	weights.push_back(1.0);
+	weights.push_back(0.5);
+	weights.push_back(0.25);
+	weights.push_back(2.0);
+
+	// Rotate and shift the targets, then push them slightly off so the fit cannot be exact.
+	const Quaternion expected_rotation = Quaternion(Vector3(0.3, 1, 0.2).normalized(), 0.9);
+	PackedVector3Array target_points;
+	for (int i = 0; i < moved_points.size(); i++) {
+		target_points.push_back(expected_rotation.xform(moved_points[i]) + Vector3(0.5, -1, 2) + Vector3(0.05 * (i % 2 ? 1 : -1), 0.03 * i, -0.02));
+	}
+
+	for (bool translate : { false, true }) {
+		QuaternionCharacteristicPolynomial::Superposition result = QuaternionCharacteristicPolynomial::superpose(moved_points, target_points, weights, translate);
+		const double measured = measure_msd(result.rotation, result.translation, moved_points, target_points, weights);
+		CHECK(result.msd == doctest::Approx(measured).epsilon(1e-4));
+		CHECK(result.get_msd(result.rotation, result.translation) == doctest::Approx(measured).epsilon(1e-4));
+
+		// Any other transform is scored from the same sums, and none beats the optimum.
+		const Quaternion other_rotation = Quaternion(Vector3(1, 0, 0), 0.2) * result.rotation;
+		const Vector3 other_translation = Vector3(0.1, 0.2, -0.3);
+		const double measured_other = measure_msd(other_rotation, other_translation, moved_points, target_points, weights);
+		CHECK(result.get_msd(other_rotation, other_translation) == doctest::Approx(measured_other).epsilon(1e-4));
+		CHECK(measured_other > result.msd);
+
+		Array array_result = QuaternionCharacteristicPolynomial::weighted_superpose(moved_points, target_points, weights, translate);
+		REQUIRE(array_result.size() == 3);
+		CHECK(double(array_result[2]) == doctest::Approx(result.msd));
+
+		// Fits that are never scored skip the residual but not the fit.
+		QuaternionCharacteristicPolynomial::Superposition unscored = QuaternionCharacteristicPolynomial::superpose(moved_points, target_points, weights, translate, 1E-6, QuaternionCharacteristicPolynomial::METHOD_QCP, false);
+		CHECK(unscored.rotation.is_equal_approx(result.rotation));
+		CHECK(unscored.translation.is_equal_approx(result.translation));
+		CHECK(unscored.weight_sum == 0.0);
+		CHECK(unscored.msd == 0.0);
+	}
+}
+
+TEST_CASE("[Modules][QCP] Advanced - Streaming Accumulator Matches Batch Superposition") {
+	// A cloud larger than the batch API accepts, far from the origin, split into uneven chunks across two partial accumulators.
+	const int point_count = 50000;
+	const Quaternion expected_rotation = Quaternion(Vector3(-0.2, 0.7, 0.4).normalized(), 1.1);
+	const Vector3 offset = Vector3(1000, -2000, 500);
+	const Vector3 expected_translation = Vector3(3, -4, 12);
+	PackedVector3Array moved_points;
+	PackedVector3Array target_points;
+	Vector<double> weights;
+	moved_points.resize(point_count);
+	target_points.resize(point_count);
+	weights.resize(point_count);
+	for (int i = 0; i < point_count; i++) {
+		Vector3 point = offset + Vector3(Math::sin(i * 0.37), Math::cos(i * 0.11) * 2.0, Math::sin(i * 0.053 + 1.0) * 0.5);
+		moved_points.write[i] = point;
+		target_points.write[i] = expected_rotation.xform(point) + expected_translation;
+		weights.write[i] = 0.5 + (i % 7) * 0.1;
+	}
+
+	QuaternionCharacteristicPolynomial::Accumulator first;
+	QuaternionCharacteristicPolynomial::Accumulator second;
+	first.begin();
+	second.begin();
+	const int split = 17321;
+	first.accumulate(moved_points.ptr(), target_points.ptr(), weights.ptr(), 1000);
+	first.accumulate(moved_points.ptr() + 1000, target_points.ptr() + 1000, weights.ptr() + 1000, split - 1000);
+	second.accumulate(moved_points.ptr() + split, target_points.ptr() + split, weights.ptr() + split, point_count - split);
+	first.merge(second);
+	double total_weight = 0.0;
+	for (int i = 0; i < point_count; i++) {
+		total_weight += weights[i];
+	}
+	CHECK(first.weight_sum == doctest::Approx(total_weight));
+
+	QuaternionCharacteristicPolynomial::Superposition result = first.solve(true);
+	CHECK_ROTATION_EQUIVALENT(result.rotation, expected_rotation, 1e-4);
+	CHECK((result.translation - expected_translation).length() < 1e-2);
+	CHECK(result.msd < 1e-6);
+
+	// The first 5000 points fit the batch API too, and both must agree.
+	QuaternionCharacteristicPolynomial::Accumulator small;
+	small.begin();
+	small.accumulate(moved_points.slice(0, 5000), target_points.slice(0, 5000), weights.slice(0, 5000));
+	for (bool translate : { false, true }) {
+		QuaternionCharacteristicPolynomial::Superposition streamed = small.solve(translate);
+		QuaternionCharacteristicPolynomial::Superposition batch = QuaternionCharacteristicPolynomial::superpose(moved_points.slice(0, 5000), target_points.slice(0, 5000), weights.slice(0, 5000), translate);
+		CHECK_ROTATION_EQUIVALENT(streamed.rotation, batch.rotation, 1e-4);
+		CHECK(streamed.get_msd(batch.rotation, batch.translation) == doctest::Approx(batch.get_msd(batch.rotation, batch.translation)).epsilon(1e-3));
+	}
+}
+
+TEST_CASE("[Modules][QCP] Advanced - Batched Superposition Matches One Problem At A Time") {
+	// Seven problems leave the last block of lanes partly empty; the stride leaves a gap after each point.
+	const int problem_count = 7;
+	const int stride = 9;
+	const int point_count = 5;
+	Vector<double> weights;
+	for (int i = 0; i < point_count; i++) {
+		weights.push_back(0.25 + 0.2 * i);
+	}
+	Vector<Vector3> moved;
+	Vector<Vector3> target;
+	moved.resize(point_count * stride);
+	target.resize(point_count * stride);
+	for (int problem = 0; problem < problem_count; problem++) {
+		const Quaternion rotation = Quaternion(Vector3(1, problem, 0.5).normalized(), 0.3 * problem);
+		for (int i = 0; i < point_count; i++) {
+			const Vector3 point = Vector3(Math::cos(i * 1.3 + problem), Math::sin(i * 0.7), 0.2 * i - 0.4);
+			moved.write[i * stride + problem] = point;
+			target.write[i * stride + problem] = rotation.xform(point) + Vector3(0.01 * i, -0.02 * problem, 0.0);
+		}
+	}
+	// Every problem's own headings collapse onto one point in the last one, which takes the scalar fallback.
+	const Vector3 single = Vector3(0, 1, 0);
+	for (int i = 0; i < point_count; i++) {
+		moved.write[i * stride + problem_count - 1] = single;
+		target.write[i * stride + problem_count - 1] = Vector3(1, 0, 0);
+	}
+
+	Quaternion rotations[problem_count];
+	double msd[problem_count];
+	QuaternionCharacteristicPolynomial::weighted_superpose_batch<double>(moved.ptr(), target.ptr(), weights.ptr(), point_count, problem_count, stride, rotations, msd);
+
+	for (int problem = 0; problem < problem_count; problem++) {
+		PackedVector3Array problem_moved;
+		PackedVector3Array problem_target;
+		for (int i = 0; i < point_count; i++) {
+			problem_moved.push_back(moved[i * stride + problem]);
+			problem_target.push_back(target[i * stride + problem]);
+		}
+		QuaternionCharacteristicPolynomial::Accumulator accumulator;
+		accumulator.accumulate(problem_moved, problem_target, weights);
+		QuaternionCharacteristicPolynomial::Superposition expected = accumulator.solve(false);
+		CHECK_ROTATION_EQUIVALENT(rotations[problem], expected.rotation, 1e-5);
+		CHECK(msd[problem] == doctest::Approx(expected.msd).epsilon(1e-4));
+	}
+	CHECK(rotations[problem_count - 1].xform(single).is_equal_approx(Vector3(1, 0, 0)));
+}
+
+static void check_accumulators_match(const QuaternionCharacteristicPolynomial::Accumulator &p_updated, const QuaternionCharacteristicPolynomial::Accumulator &p_recomputed) {
+	CHECK(p_updated.weight_sum == doctest::Approx(p_recomputed.weight_sum));
+	CHECK(p_updated.moved_squared_deviation == doctest::Approx(p_recomputed.moved_squared_deviation).epsilon(1e-5));
+	CHECK(p_updated.target_squared_deviation == doctest::Approx(p_recomputed.target_squared_deviation).epsilon(1e-5));
+	for (int a = 0; a < 3; a++) {
+		CHECK(p_updated.moved_mean[a] == doctest::Approx(p_recomputed.moved_mean[a]).epsilon(1e-5));
+		CHECK(p_updated.target_mean[a] == doctest::Approx(p_recomputed.target_mean[a]).epsilon(1e-5));
+		for (int b = 0; b < 3; b++) {
+			CHECK(p_updated.co_moment[a][b] == doctest::Approx(p_recomputed.co_moment[a][b]).epsilon(1e-5));
+		}
+	}
+	for (bool translate : { false, true }) {
+		CHECK_ROTATION_EQUIVALENT(p_updated.solve(translate).rotation, p_recomputed.solve(translate).rotation, 1e-5);
+	}
+}
+
+TEST_CASE("[Modules][QCP] Advanced - Incremental Accumulator Updates Match A Full Recompute") {
+	const int point_count = 40;
+	PackedVector3Array moved_points;
+	PackedVector3Array target_points;
+	Vector<double> weights;
+	const Quaternion rotation = Quaternion(Vector3(0.4, -0.3, 1).normalized(), 0.6);
+	for (int i = 0; i < point_count; i++) {
+		Vector3 point = Vector3(Math::sin(i * 0.9), Math::cos(i * 0.4) * 1.5, (i % 5) * 0.3);
+		moved_points.push_back(point);
+		target_points.push_back(rotation.xform(point) + Vector3(2, 0, -1) + Vector3(0.02 * (i % 3), 0, -0.01 * (i % 4)));
+		weights.push_back(0.3 + (i % 4) * 0.25);
+	}
+
+	SUBCASE("Removing points") {
+		QuaternionCharacteristicPolynomial::Accumulator updated;
+		updated.accumulate(moved_points, target_points, weights);
+		updated.remove(moved_points.slice(10, 25), target_points.slice(10, 25), weights.slice(10, 25));
+
+		QuaternionCharacteristicPolynomial::Accumulator recomputed;
+		recomputed.accumulate(moved_points.slice(0, 10), target_points.slice(0, 10), weights.slice(0, 10));
+		recomputed.accumulate(moved_points.slice(25), target_points.slice(25), weights.slice(25));
+		check_accumulators_match(updated, recomputed);
+
+		// Swapping one effector's heading for its new value is a removal and an addition.
+		PackedVector3Array moved_target_point;
+		moved_target_point.push_back(target_points[3] + Vector3(0.5, 0.1, 0));
+		updated.remove(moved_points.slice(3, 4), target_points.slice(3, 4), weights.slice(3, 4));
+		updated.accumulate(moved_points.slice(3, 4), moved_target_point, weights.slice(3, 4));
+		PackedVector3Array changed_targets = target_points;
+		changed_targets.set(3, moved_target_point[0]);
+		recomputed.begin();
+		recomputed.accumulate(moved_points.slice(0, 10), changed_targets.slice(0, 10), weights.slice(0, 10));
+		recomputed.accumulate(moved_points.slice(25), changed_targets.slice(25), weights.slice(25));
+		check_accumulators_match(updated, recomputed);
+	}
+
+	SUBCASE("Rigid motion of either set") {
+		const Basis moved_rotation = Basis(Vector3(1, 1, 0).normalized(), 0.8);
+		const Vector3 moved_translation = Vector3(-3, 0.5, 4);
+		const Basis target_rotation = Basis(Vector3(0, 0.2, 1).normalized(), -1.1);
+		const Vector3 target_translation = Vector3(0.25, -7, 1);
+
+		QuaternionCharacteristicPolynomial::Accumulator updated;
+		updated.accumulate(moved_points, target_points, weights);
+		updated.transform_moved(moved_rotation, moved_translation);
+		updated.transform_target(target_rotation, target_translation);
+
+		PackedVector3Array transformed_moved;
+		PackedVector3Array transformed_target;
+		for (int i = 0; i < point_count; i++) {
+			transformed_moved.push_back(moved_rotation.xform(moved_points[i]) + moved_translation);
+			transformed_target.push_back(target_rotation.xform(target_points[i]) + target_translation);
+		}
+		QuaternionCharacteristicPolynomial::Accumulator recomputed;
+		recomputed.accumulate(transformed_moved, transformed_target, weights);
+		check_accumulators_match(updated, recomputed);
+	}
+
+	SUBCASE("Removing everything leaves an empty accumulator") {
+		QuaternionCharacteristicPolynomial::Accumulator updated;
+		updated.accumulate(moved_points, target_points, weights);
+		updated.remove(moved_points, target_points, weights);
+		CHECK(updated.weight_sum == 0.0);
+		CHECK(updated.solve(true).rotation.is_equal_approx(Quaternion()));
+	}
+}
+
 } // namespace TestQCPAdvanced
@@ -0,0 +1,318 @@
+/**************************************************************************/
+/*  test_qcp_benchmark.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "modules/many_bone_ik/src/ik_kusudama_3d.h"
+#include "modules/many_bone_ik/src/ik_open_cone_3d.h"
+#include "test_qcp_fixtures.h"
+#include "test_qcp_helpers.h"
+#include "tests/test_macros.h"
+
+#include "core/os/os.h"
+
+using namespace TestQCPFixtures;
+
+namespace TestQCPBenchmark {
+
+struct PointSetFixture {
+	PackedVector3Array points;
+	const char *description;
+	bool well_conditioned;
+};
+
+static Vector<PointSetFixture> create_benchmark_point_sets() {
+	Vector<PointSetFixture> point_sets;
+	point_sets.push_back({ create_complex_multi_point_set(), "complex multi-point", true });
+	point_sets.push_back({ create_performance_test_points(100), "100 point helix", true });
+	point_sets.push_back({ create_performance_test_points(7), "7 point helix", true });
+	point_sets.push_back({ create_nearly_parallel_vectors(), "nearly parallel", false });
+	point_sets.push_back({ create_large_value_points(), "large values", false });
+	point_sets.push_back({ create_small_value_points(), "small values", false });
+	return point_sets;
+}
+
+TEST_CASE("[Modules][QCP] Benchmark - Superposition Methods Across The Fixtures") {
+	const QuaternionCharacteristicPolynomial::SuperpositionMethod methods[] = {
+		QuaternionCharacteristicPolynomial::METHOD_QCP,
+		QuaternionCharacteristicPolynomial::METHOD_HORN,
+		QuaternionCharacteristicPolynomial::METHOD_KABSCH,
+	};
+
+	Vector<PointSetFixture> point_sets = create_benchmark_point_sets();
+	for (int method_i = 0; method_i < 3; method_i++) {
+		for (const PointSetFixture &point_set : point_sets) {
+			const Vector<double> weights = TestQCPHelpers::create_uniform_weights(point_set.points.size());
+			double worst_fixture_error = 0.0;
+			for (const RotationFixture &rotation_fixture : STANDARD_ROTATIONS) {
+				for (const Vector3 &translation : STANDARD_TRANSLATIONS) {
+					PackedVector3Array target_points;
+					for (const Vector3 &point : point_set.points) {
+						target_points.push_back(rotation_fixture.rotation.xform(point) + translation);
+					}
+					QuaternionCharacteristicPolynomial::Superposition result = QuaternionCharacteristicPolynomial::superpose(point_set.points, target_points, weights, true, 1E-6, methods[method_i]);
+					const double error = result.rotation.angle_to(rotation_fixture.rotation);
+					worst_fixture_error = MAX(worst_fixture_error, error);
+				}
+			}
+			if (point_set.well_conditioned) {
+				INFO(point_set.description);
+				CHECK(worst_fixture_error < 1e-3);
+			}
+		}
+	}
+}
+
+// Timings are too noisy for the unit run; run with --no-skip to see them.
+TEST_CASE("[Benchmark][Modules][QCP] Benchmark - Superposition Method Latency Across The Fixtures" * doctest::skip()) {
+	const QuaternionCharacteristicPolynomial::SuperpositionMethod methods[] = {
+		QuaternionCharacteristicPolynomial::METHOD_QCP,
+		QuaternionCharacteristicPolynomial::METHOD_HORN,
+		QuaternionCharacteristicPolynomial::METHOD_KABSCH,
+	};
+	const char *method_names[] = { "QCP", "Horn", "Kabsch" };
+	// Calls are timed in groups, since a single superposition is below the clock's resolution.
+	const int CALLS_PER_SAMPLE = 64;
+	const int SAMPLES = 16;
+
+	Vector<PointSetFixture> point_sets = create_benchmark_point_sets();
+	for (int method_i = 0; method_i < 3; method_i++) {
+		double worst_error = 0.0;
+		double worst_sample_usec = 0.0;
+		double total_usec = 0.0;
+		int sample_count = 0;
+		for (const PointSetFixture &point_set : point_sets) {
+			const Vector<double> weights = TestQCPHelpers::create_uniform_weights(point_set.points.size());
+			double worst_fixture_error = 0.0;
+			double worst_fixture_sample_usec = 0.0;
+			for (const RotationFixture &rotation_fixture : STANDARD_ROTATIONS) {
+				for (const Vector3 &translation : STANDARD_TRANSLATIONS) {
+					PackedVector3Array target_points;
+					for (const Vector3 &point : point_set.points) {
+						target_points.push_back(rotation_fixture.rotation.xform(point) + translation);
+					}
+					QuaternionCharacteristicPolynomial::Superposition result;
+					for (int sample_i = 0; sample_i < SAMPLES; sample_i++) {
+						const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+						for (int call_i = 0; call_i < CALLS_PER_SAMPLE; call_i++) {
+							result = QuaternionCharacteristicPolynomial::superpose(point_set.points, target_points, weights, true, 1E-6, methods[method_i]);
+						}
+						const double sample_usec = double(OS::get_singleton()->get_ticks_usec() - begin) / CALLS_PER_SAMPLE;
+						worst_fixture_sample_usec = MAX(worst_fixture_sample_usec, sample_usec);
+						total_usec += sample_usec;
+						sample_count++;
+					}
+					worst_fixture_error = MAX(worst_fixture_error, double(result.rotation.angle_to(rotation_fixture.rotation)));
+				}
+			}
+			MESSAGE(vformat("%s on %s: worst sample %.3f usec per call, worst rotation error %.3e rad.", method_names[method_i], point_set.description, worst_fixture_sample_usec, worst_fixture_error));
+			worst_sample_usec = MAX(worst_sample_usec, worst_fixture_sample_usec);
+			if (point_set.well_conditioned) {
+				worst_error = MAX(worst_error, worst_fixture_error);
+			}
+		}
+		// The worst sample comes first: a solver that is fast on average but spikes still drops frames.
+		const double mean_usec = total_usec / sample_count;
+		MESSAGE(vformat("%s: worst sample %.3f usec per call, mean %.3f usec, worst to mean %.2f, worst well-conditioned error %.3e rad.", method_names[method_i], worst_sample_usec, mean_usec, worst_sample_usec / MAX(mean_usec, 1e-9), worst_error));
+		CHECK(worst_error < 1e-3);
+	}
+}
+
+TEST_CASE("[Modules][QCP] Benchmark - Methods Agree On A Noisy Fit") {
+	PackedVector3Array moved_points = create_performance_test_points(30);
+	PackedVector3Array target_points;
+	const Quaternion rotation = Quaternion(Vector3(0.2, -1, 0.4).normalized(), 2.5);
+	for (int i = 0; i < moved_points.size(); i++) {
+		target_points.push_back(rotation.xform(moved_points[i]) + Vector3(0.05 * Math::sin(i * 3.1), 0.04 * Math::cos(i * 1.7), 0.03 * (i % 3)));
+	}
+	const Vector<double> weights = TestQCPHelpers::create_uniform_weights(moved_points.size());
+	QuaternionCharacteristicPolynomial::Superposition qcp = QuaternionCharacteristicPolynomial::superpose(moved_points, target_points, weights, false, 1E-6, QuaternionCharacteristicPolynomial::METHOD_QCP);
+	QuaternionCharacteristicPolynomial::Superposition horn = QuaternionCharacteristicPolynomial::superpose(moved_points, target_points, weights, false, 1E-6, QuaternionCharacteristicPolynomial::METHOD_HORN);
+	QuaternionCharacteristicPolynomial::Superposition kabsch = QuaternionCharacteristicPolynomial::superpose(moved_points, target_points, weights, false, 1E-6, QuaternionCharacteristicPolynomial::METHOD_KABSCH);
+	// The residual does not depend on the method, and the Horn and Kabsch rotations must attain it.
+	CHECK(horn.get_msd(horn.rotation) == doctest::Approx(qcp.msd).epsilon(1e-4));
+	CHECK(kabsch.get_msd(kabsch.rotation) == doctest::Approx(qcp.msd).epsilon(1e-4));
+	CHECK(horn.rotation.angle_to(kabsch.rotation) < 1e-4);
+}
+
+// Heading-sized problems: a handful of unit-scale points per bone, many bones, each with a little noise.
+struct HeadingBatchFixture {
+	int point_count = 7;
+	int problem_count = 256;
+	Vector<Vector3> moved;
+	Vector<Vector3> target;
+	Vector<double> weights;
+	Vector<Quaternion> applied;
+};
+
+static HeadingBatchFixture create_heading_batch_fixture() {
+	HeadingBatchFixture fixture;
+	for (int problem = 0; problem < fixture.problem_count; problem++) {
+		fixture.applied.push_back(Quaternion(Vector3(Math::sin(problem * 0.7), 1.0, Math::cos(problem * 1.3)).normalized(), 0.01 * problem));
+	}
+	for (int i = 0; i < fixture.point_count; i++) {
+		fixture.weights.push_back(1.0 + 0.25 * i);
+		for (int problem = 0; problem < fixture.problem_count; problem++) {
+			const Vector3 point = Vector3(Math::cos(i * 2.1 + problem), Math::sin(i * 1.3), 0.5 * (i % 3) - 0.4);
+			fixture.moved.push_back(point);
+			fixture.target.push_back(fixture.applied[problem].xform(point) + Vector3(0.002 * Math::sin(i + problem), 0.0, 0.001 * i));
+		}
+	}
+	return fixture;
+}
+
+template <typename T>
+static void solve_heading_batch(const HeadingBatchFixture &p_fixture, Vector<Quaternion> &r_rotations, Vector<double> &r_msd) {
+	r_rotations.resize(p_fixture.problem_count);
+	r_msd.resize(p_fixture.problem_count);
+	QuaternionCharacteristicPolynomial::weighted_superpose_batch<T>(p_fixture.moved.ptr(), p_fixture.target.ptr(), p_fixture.weights.ptr(), p_fixture.point_count, p_fixture.problem_count, p_fixture.problem_count, r_rotations.ptrw(), r_msd.ptrw());
+}
+
+// Fits every standard rotation of a point set with both batch kernels and returns the largest angle between their rotations.
+static double get_batch_kernel_difference(const PackedVector3Array &p_points) {
+	const Vector<double> weights = TestQCPHelpers::create_uniform_weights(p_points.size());
+	double worst_difference = 0.0;
+	for (const RotationFixture &rotation_fixture : STANDARD_ROTATIONS) {
+		PackedVector3Array target_points;
+		for (const Vector3 &point : p_points) {
+			target_points.push_back(rotation_fixture.rotation.xform(point));
+		}
+		Quaternion double_rotation;
+		Quaternion float_rotation;
+		QuaternionCharacteristicPolynomial::weighted_superpose_batch<double>(p_points.ptr(), target_points.ptr(), weights.ptr(), p_points.size(), 1, 1, &double_rotation);
+		QuaternionCharacteristicPolynomial::weighted_superpose_batch<float>(p_points.ptr(), target_points.ptr(), weights.ptr(), p_points.size(), 1, 1, &float_rotation);
+		worst_difference = MAX(worst_difference, double(double_rotation.angle_to(float_rotation)));
+	}
+	return worst_difference;
+}
+
+// Clamps the bone direction each kernel fits for the heading batch through the two-cone kusudama of the kusudama tests,
+// and returns the largest angle between the clamped directions.
+static double get_batch_kernel_kusudama_difference(const HeadingBatchFixture &p_fixture, const Vector<Quaternion> &p_double_rotations, const Vector<Quaternion> &p_float_rotations) {
+	Ref<IKKusudama3D> kusudama;
+	kusudama.instantiate();
+	Ref<IKLimitCone3D> cone_a;
+	cone_a.instantiate();
+	cone_a->set_attached_to(kusudama);
+	cone_a->set_radius(Math::PI / 6);
+	cone_a->set_control_point(Vector3(0, 0, 1));
+	kusudama->add_open_cone(cone_a);
+	Ref<IKLimitCone3D> cone_b;
+	cone_b.instantiate();
+	cone_b->set_attached_to(kusudama);
+	cone_b->set_radius(Math::PI / 8);
+	cone_b->set_control_point(Vector3(1, 0, 1).normalized());
+	kusudama->add_open_cone(cone_b);
+
+	double worst_difference = 0.0;
+	Vector<double> bounds;
+	bounds.resize(2);
+	for (int problem = 0; problem < p_fixture.problem_count; problem++) {
+		bounds.write[0] = -1;
+		bounds.write[1] = 0;
+		const Vector3 double_direction = kusudama->get_local_point_in_limits(p_double_rotations[problem].xform(Vector3(0, 0, 1)), &bounds);
+		bounds.write[0] = -1;
+		bounds.write[1] = 0;
+		const Vector3 float_direction = kusudama->get_local_point_in_limits(p_float_rotations[problem].xform(Vector3(0, 0, 1)), &bounds);
+		worst_difference = MAX(worst_difference, double(double_direction.angle_to(float_direction)));
+	}
+	return worst_difference;
+}
+
+TEST_CASE("[Modules][QCP] Benchmark - Float And Double Batch Kernels") {
+	const HeadingBatchFixture fixture = create_heading_batch_fixture();
+	Vector<Quaternion> double_rotations;
+	Vector<Quaternion> float_rotations;
+	Vector<double> double_msd;
+	Vector<double> float_msd;
+	solve_heading_batch<double>(fixture, double_rotations, double_msd);
+	solve_heading_batch<float>(fixture, float_rotations, float_msd);
+
+	double worst_double_error = 0.0;
+	double worst_float_error = 0.0;
+	double worst_msd_difference = 0.0;
+	for (int problem = 0; problem < fixture.problem_count; problem++) {
+		worst_double_error = MAX(worst_double_error, double(double_rotations[problem].angle_to(fixture.applied[problem])));
+		worst_float_error = MAX(worst_float_error, double(float_rotations[problem].angle_to(fixture.applied[problem])));
+		worst_msd_difference = MAX(worst_msd_difference, Math::abs(float_msd[problem] - double_msd[problem]));
+	}
+	// The noise bounds how well either kernel can recover the applied rotations; float may only add round-off on top.
+	CHECK(worst_double_error < 1e-2);
+	CHECK(worst_float_error < worst_double_error + 1e-3);
+	CHECK(worst_msd_difference < 1e-4);
+	// Round-off must not move a clamped bone direction either.
+	CHECK(get_batch_kernel_kusudama_difference(fixture, double_rotations, float_rotations) < 1e-3);
+}
+
+TEST_CASE("[Modules][QCP] Benchmark - Float And Double Batch Kernels Agree On The Fixtures") {
+	for (const PointSetFixture &point_set : create_benchmark_point_sets()) {
+		if (point_set.well_conditioned) {
+			INFO(point_set.description);
+			CHECK(get_batch_kernel_difference(point_set.points) < 1e-3);
+		}
+	}
+}
+
+template <typename T>
+static double time_heading_batch_usec(const HeadingBatchFixture &p_fixture, Vector<Quaternion> &r_rotations, Vector<double> &r_msd) {
+	const int REPEATS = 32;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int repeat_i = 0; repeat_i < REPEATS; repeat_i++) {
+		solve_heading_batch<T>(p_fixture, r_rotations, r_msd);
+	}
+	return double(OS::get_singleton()->get_ticks_usec() - begin) / REPEATS;
+}
+
+// Timings are too noisy for the unit run; run with --no-skip to see them.
+TEST_CASE("[Benchmark][Modules][QCP] Benchmark - Float And Double Batch Kernel Timing And Accuracy" * doctest::skip()) {
+	const HeadingBatchFixture fixture = create_heading_batch_fixture();
+	Vector<Quaternion> double_rotations;
+	Vector<Quaternion> float_rotations;
+	Vector<double> double_msd;
+	Vector<double> float_msd;
+	const double double_usec = time_heading_batch_usec<double>(fixture, double_rotations, double_msd);
+	const double float_usec = time_heading_batch_usec<float>(fixture, float_rotations, float_msd);
+	double worst_double_error = 0.0;
+	double worst_float_error = 0.0;
+	double worst_msd_difference = 0.0;
+	for (int problem = 0; problem < fixture.problem_count; problem++) {
+		worst_double_error = MAX(worst_double_error, double(double_rotations[problem].angle_to(fixture.applied[problem])));
+		worst_float_error = MAX(worst_float_error, double(float_rotations[problem].angle_to(fixture.applied[problem])));
+		worst_msd_difference = MAX(worst_msd_difference, Math::abs(float_msd[problem] - double_msd[problem]));
+	}
+	MESSAGE(vformat("double kernel: %.3f usec per %d problems, worst rotation error %.3e rad.", double_usec, fixture.problem_count, worst_double_error));
+	MESSAGE(vformat("float kernel: %.3f usec per %d problems, worst rotation error %.3e rad, worst msd difference %.3e.", float_usec, fixture.problem_count, worst_float_error, worst_msd_difference));
+	MESSAGE(vformat("Kusudama-clamped bone directions differ by at most %.3e rad.", get_batch_kernel_kusudama_difference(fixture, double_rotations, float_rotations)));
+	for (const PointSetFixture &point_set : create_benchmark_point_sets()) {
+		MESSAGE(vformat("%s: float and double rotations differ by at most %.3e rad.", point_set.description, get_batch_kernel_difference(point_set.points)));
+	}
+}
+
+} // namespace TestQCPBenchmark